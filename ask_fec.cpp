@@ -0,0 +1,213 @@
+/*
+	Mbed OS ASK forward error correction version 1.0.0 2026-10-19 by Santtu Nyman.
+	This file is part of mbed-os-ask "https://github.com/Santtu-Nyman/mbed-os-ask".
+*/
+
+#include "ask_fec.h"
+
+// exponent table of GF(256) generated by primitive polynomial 0x11D and generator element 2
+// the table is repeated to avoid modulo operation in multiplication
+static const uint8_t _ask_fec_exponent_table[512] = {
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26,
+	0x4C, 0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0,
+	0x9D, 0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23,
+	0x46, 0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1,
+	0x5F, 0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0,
+	0xFD, 0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2,
+	0xD9, 0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE,
+	0x81, 0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC,
+	0x85, 0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54,
+	0xA8, 0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73,
+	0xE6, 0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF,
+	0xE3, 0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41,
+	0x82, 0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6,
+	0x51, 0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09,
+	0x12, 0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16,
+	0x2C, 0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E, 0x01,
+	0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26, 0x4C,
+	0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x9D,
+	0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23, 0x46,
+	0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1, 0x5F,
+	0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0, 0xFD,
+	0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2, 0xD9,
+	0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE, 0x81,
+	0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC, 0x85,
+	0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54, 0xA8,
+	0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73, 0xE6,
+	0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF, 0xE3,
+	0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41, 0x82,
+	0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6, 0x51,
+	0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09, 0x12,
+	0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16, 0x2C,
+	0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E, 0x01, 0x02 };
+
+// logarithm table of GF(256), logarithm of 0 is undefined and its entry is 0
+static const uint8_t _ask_fec_logarithm_table[256] = {
+	0x00, 0x00, 0x01, 0x19, 0x02, 0x32, 0x1A, 0xC6, 0x03, 0xDF, 0x33, 0xEE, 0x1B, 0x68, 0xC7, 0x4B,
+	0x04, 0x64, 0xE0, 0x0E, 0x34, 0x8D, 0xEF, 0x81, 0x1C, 0xC1, 0x69, 0xF8, 0xC8, 0x08, 0x4C, 0x71,
+	0x05, 0x8A, 0x65, 0x2F, 0xE1, 0x24, 0x0F, 0x21, 0x35, 0x93, 0x8E, 0xDA, 0xF0, 0x12, 0x82, 0x45,
+	0x1D, 0xB5, 0xC2, 0x7D, 0x6A, 0x27, 0xF9, 0xB9, 0xC9, 0x9A, 0x09, 0x78, 0x4D, 0xE4, 0x72, 0xA6,
+	0x06, 0xBF, 0x8B, 0x62, 0x66, 0xDD, 0x30, 0xFD, 0xE2, 0x98, 0x25, 0xB3, 0x10, 0x91, 0x22, 0x88,
+	0x36, 0xD0, 0x94, 0xCE, 0x8F, 0x96, 0xDB, 0xBD, 0xF1, 0xD2, 0x13, 0x5C, 0x83, 0x38, 0x46, 0x40,
+	0x1E, 0x42, 0xB6, 0xA3, 0xC3, 0x48, 0x7E, 0x6E, 0x6B, 0x3A, 0x28, 0x54, 0xFA, 0x85, 0xBA, 0x3D,
+	0xCA, 0x5E, 0x9B, 0x9F, 0x0A, 0x15, 0x79, 0x2B, 0x4E, 0xD4, 0xE5, 0xAC, 0x73, 0xF3, 0xA7, 0x57,
+	0x07, 0x70, 0xC0, 0xF7, 0x8C, 0x80, 0x63, 0x0D, 0x67, 0x4A, 0xDE, 0xED, 0x31, 0xC5, 0xFE, 0x18,
+	0xE3, 0xA5, 0x99, 0x77, 0x26, 0xB8, 0xB4, 0x7C, 0x11, 0x44, 0x92, 0xD9, 0x23, 0x20, 0x89, 0x2E,
+	0x37, 0x3F, 0xD1, 0x5B, 0x95, 0xBC, 0xCF, 0xCD, 0x90, 0x87, 0x97, 0xB2, 0xDC, 0xFC, 0xBE, 0x61,
+	0xF2, 0x56, 0xD3, 0xAB, 0x14, 0x2A, 0x5D, 0x9E, 0x84, 0x3C, 0x39, 0x53, 0x47, 0x6D, 0x41, 0xA2,
+	0x1F, 0x2D, 0x43, 0xD8, 0xB7, 0x7B, 0xA4, 0x76, 0xC4, 0x17, 0x49, 0xEC, 0x7F, 0x0C, 0x6F, 0xF6,
+	0x6C, 0xA1, 0x3B, 0x52, 0x29, 0x9D, 0x55, 0xAA, 0xFB, 0x60, 0x86, 0xB1, 0xBB, 0xCC, 0x3E, 0x5A,
+	0xCB, 0x59, 0x5F, 0xB0, 0x9C, 0xA9, 0xA0, 0x51, 0x0B, 0xF5, 0x16, 0xEB, 0x7A, 0x75, 0x2C, 0xD7,
+	0x4F, 0xAE, 0xD5, 0xE9, 0xE6, 0xE7, 0xAD, 0xE8, 0x74, 0xD6, 0xF4, 0xEA, 0xA8, 0x50, 0x58, 0xAF };
+
+// coefficients of the code generator polynomial (x - 1)(x - 2)(x - 2^2)...(x - 2^(ASK_FEC_PARITY_SIZE - 1)) from highest degree to lowest, the leading 1 is not stored
+static const uint8_t _ask_fec_generator_polynomial[ASK_FEC_PARITY_SIZE] = { 0xFF, 0x0B, 0x51, 0x36, 0xEF, 0xAD, 0xC8, 0x18 };
+
+static inline uint8_t _ask_fec_multiply(uint8_t a, uint8_t b)
+{
+	if (!a || !b)
+		return 0;
+	return _ask_fec_exponent_table[_ask_fec_logarithm_table[a] + _ask_fec_logarithm_table[b]];
+}
+
+static inline uint8_t _ask_fec_divide(uint8_t a, uint8_t b)
+{
+	// the function assumes that b is not 0
+	if (!a)
+		return 0;
+	return _ask_fec_exponent_table[_ask_fec_logarithm_table[a] + 255 - _ask_fec_logarithm_table[b]];
+}
+
+static inline uint8_t _ask_fec_power(int exponent)
+{
+	// exponent of the generator element is reduced to range from 0 to 254
+	exponent %= 255;
+	if (exponent < 0)
+		exponent += 255;
+	return _ask_fec_exponent_table[exponent];
+}
+
+void ask_fec_encode_init(uint8_t* parity)
+{
+	for (size_t i = 0; i != ASK_FEC_PARITY_SIZE; ++i)
+		parity[i] = 0;
+}
+
+void ask_fec_encode_byte(uint8_t* parity, uint8_t data)
+{
+	// parity is the remainder of the data divided by the generator polynomial and it is calculated like crc
+	uint8_t feedback = data ^ parity[0];
+	for (size_t i = 0; i != ASK_FEC_PARITY_SIZE - 1; ++i)
+		parity[i] = parity[i + 1] ^ _ask_fec_multiply(feedback, _ask_fec_generator_polynomial[i]);
+	parity[ASK_FEC_PARITY_SIZE - 1] = _ask_fec_multiply(feedback, _ask_fec_generator_polynomial[ASK_FEC_PARITY_SIZE - 1]);
+}
+
+int ask_fec_decode(uint8_t* block, size_t block_size)
+{
+	if (block_size <= ASK_FEC_PARITY_SIZE || block_size > ASK_FEC_MAXIMUM_BLOCK_SIZE)
+		return -1;
+
+	// calculate syndromes by evaluating the block at roots of the generator polynomial
+	uint8_t syndromes[ASK_FEC_PARITY_SIZE];
+	uint8_t syndrome_sum = 0;
+	for (size_t i = 0; i != ASK_FEC_PARITY_SIZE; ++i)
+	{
+		uint8_t root = _ask_fec_exponent_table[i];
+		uint8_t syndrome = 0;
+		for (size_t j = 0; j != block_size; ++j)
+			syndrome = _ask_fec_multiply(syndrome, root) ^ block[j];
+		syndromes[i] = syndrome;
+		syndrome_sum |= syndrome;
+	}
+
+	// if all syndromes are 0 the block does not contain errors
+	if (!syndrome_sum)
+		return 0;
+
+	// find error locator polynomial with Berlekamp-Massey algorithm, coefficients are stored from lowest degree to highest
+	uint8_t locator[ASK_FEC_PARITY_SIZE + 1] = { 1 };
+	uint8_t previous_locator[ASK_FEC_PARITY_SIZE + 1] = { 1 };
+	uint8_t temporal_locator[ASK_FEC_PARITY_SIZE + 1];
+	uint8_t previous_discrepancy = 1;
+	int error_count = 0;
+	int shift = 1;
+	for (int i = 0; i != ASK_FEC_PARITY_SIZE; ++i)
+	{
+		uint8_t discrepancy = syndromes[i];
+		for (int j = 1; j <= error_count; ++j)
+			discrepancy ^= _ask_fec_multiply(locator[j], syndromes[i - j]);
+
+		if (discrepancy)
+		{
+			uint8_t coefficient = _ask_fec_divide(discrepancy, previous_discrepancy);
+			if (2 * error_count <= i)
+			{
+				for (int j = 0; j != ASK_FEC_PARITY_SIZE + 1; ++j)
+					temporal_locator[j] = locator[j];
+				for (int j = shift; j != ASK_FEC_PARITY_SIZE + 1; ++j)
+					locator[j] ^= _ask_fec_multiply(coefficient, previous_locator[j - shift]);
+				for (int j = 0; j != ASK_FEC_PARITY_SIZE + 1; ++j)
+					previous_locator[j] = temporal_locator[j];
+				error_count = i + 1 - error_count;
+				previous_discrepancy = discrepancy;
+				shift = 1;
+			}
+			else
+			{
+				for (int j = shift; j != ASK_FEC_PARITY_SIZE + 1; ++j)
+					locator[j] ^= _ask_fec_multiply(coefficient, previous_locator[j - shift]);
+				++shift;
+			}
+		}
+		else
+			++shift;
+	}
+
+	// the code can not correct more than half of parity size errors
+	if (2 * error_count > ASK_FEC_PARITY_SIZE)
+		return -1;
+
+	// calculate error evaluator polynomial that is product of syndrome polynomial and error locator polynomial modulo x^ASK_FEC_PARITY_SIZE
+	uint8_t evaluator[ASK_FEC_PARITY_SIZE];
+	for (int i = 0; i != ASK_FEC_PARITY_SIZE; ++i)
+	{
+		uint8_t coefficient = 0;
+		for (int j = 0; j <= i && j <= error_count; ++j)
+			coefficient ^= _ask_fec_multiply(syndromes[i - j], locator[j]);
+		evaluator[i] = coefficient;
+	}
+
+	// search error locations with Chien search and correct them by Forney algorithm
+	// byte at index i of the block is coefficient of x^(block_size - 1 - i)
+	int errors_corrected = 0;
+	for (size_t i = 0; i != block_size; ++i)
+	{
+		int location = (int)(block_size - 1 - i);
+
+		// evaluate error locator polynomial at inverse of the location
+		uint8_t locator_value = 0;
+		for (int j = 0; j <= error_count; ++j)
+			locator_value ^= _ask_fec_multiply(locator[j], _ask_fec_power(-location * j));
+		if (locator_value)
+			continue;
+
+		// error value is location * evaluator(inverse location) / derivative of locator(inverse location)
+		uint8_t evaluator_value = 0;
+		for (int j = 0; j != ASK_FEC_PARITY_SIZE; ++j)
+			evaluator_value ^= _ask_fec_multiply(evaluator[j], _ask_fec_power(-location * j));
+		uint8_t derivative_value = 0;
+		for (int j = 1; j <= error_count; j += 2)
+			derivative_value ^= _ask_fec_multiply(locator[j], _ask_fec_power(-location * (j - 1)));
+		if (!derivative_value)
+			return -1;
+
+		block[i] ^= _ask_fec_multiply(_ask_fec_power(location), _ask_fec_divide(evaluator_value, derivative_value));
+		++errors_corrected;
+	}
+
+	// if number of found error locations does not match degree of the error locator the block has too many errors to correct
+	if (errors_corrected != error_count)
+		return -1;
+
+	return errors_corrected;
+}
@@ -0,0 +1,73 @@
+/*
+	Mbed OS ASK forward error correction version 1.0.0 2026-10-19 by Santtu Nyman.
+	This file is part of mbed-os-ask "https://github.com/Santtu-Nyman/mbed-os-ask".
+
+	Description
+		Reed-Solomon forward error correction code over GF(256) for ask transmitter and receiver.
+		The code appends ASK_FEC_PARITY_SIZE parity bytes to a block of data and it can correct up to ASK_FEC_PARITY_SIZE / 2 erroneous bytes in the block.
+		Blocks shorter than 255 bytes are encoded as shortened code.
+		All arithmetic is done by exponent and logarithm tables.
+
+	Version history
+		version 1.0.0 2026-10-19
+			First version.
+*/
+
+#ifndef ASK_FEC_H
+#define ASK_FEC_H
+
+#define ASK_FEC_VERSION_MAJOR 1
+#define ASK_FEC_VERSION_MINOR 0
+#define ASK_FEC_VERSION_PATCH 0
+
+#define ASK_FEC_IS_VERSION_ATLEAST(h, m, l) ((((unsigned long)(h) << 16) | ((unsigned long)(m) << 8) | (unsigned long)(l)) <= ((ASK_FEC_VERSION_MAJOR << 16) | (ASK_FEC_VERSION_MINOR << 8) | ASK_FEC_VERSION_PATCH))
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ASK_FEC_PARITY_SIZE 8
+#define ASK_FEC_MAXIMUM_BLOCK_SIZE 255
+
+void ask_fec_encode_init(uint8_t* parity);
+/*
+	Description
+		Initializes parity of a block before encoding it.
+	Parameters
+		parity
+			Pointer to buffer of ASK_FEC_PARITY_SIZE bytes that receives the parity.
+	Return
+		No return value.
+*/
+
+void ask_fec_encode_byte(uint8_t* parity, uint8_t data);
+/*
+	Description
+		Updates parity of a block with next byte of the block.
+		After all data bytes of the block are encoded the parity bytes are appended to the block in order of the parity buffer.
+		Total size of the block with the parity is limited to ASK_FEC_MAXIMUM_BLOCK_SIZE.
+	Parameters
+		parity
+			Pointer to parity buffer initialized by ask_fec_encode_init.
+		data
+			Next byte of the block.
+	Return
+		No return value.
+*/
+
+int ask_fec_decode(uint8_t* block, size_t block_size);
+/*
+	Description
+		Corrects errors of a block that is encoded with ask_fec_encode_byte.
+		Block is corrected in place.
+	Parameters
+		block
+			Pointer to the block including the parity bytes at its end.
+		block_size
+			Size of the block including the parity bytes.
+			Value of this parameter needs to be greater than ASK_FEC_PARITY_SIZE and not greater than ASK_FEC_MAXIMUM_BLOCK_SIZE.
+	Return
+		If the block is corrected or it had no errors, the return value is number of corrected bytes.
+		If the block can not be corrected, the return value is -1.
+*/
+
+#endif
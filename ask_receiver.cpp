@@ -1,5 +1,5 @@
 /*
-	Mbed OS ASK receiver version 1.4.1 2018-08-01 by Santtu Nyman.
+	Mbed OS ASK receiver version 1.13.1 2026-10-19 by Santtu Nyman.
 	This file is part of mbed-os-ask "https://github.com/Santtu-Nyman/mbed-os-ask".
 */
 
@@ -11,26 +11,42 @@ static ask_receiver_t* _ask_receiver;
 ask_receiver_t::ask_receiver_t()
 {
 	_is_initialized = false;
+	_is_suspended = false;
+	_clear_entropy_pool();
 }
 
 ask_receiver_t::ask_receiver_t(int rx_frequency, PinName rx_pin)
 {
 	_is_initialized = false;
+	_is_suspended = false;
+	_clear_entropy_pool();
 	init(rx_frequency, rx_pin);
 }
 
 ask_receiver_t::ask_receiver_t(int rx_frequency, PinName rx_pin, uint8_t new_rx_address)
 {
 	_is_initialized = false;
+	_is_suspended = false;
+	_clear_entropy_pool();
 	init(rx_frequency, rx_pin, new_rx_address);
 }
 
 ask_receiver_t::ask_receiver_t(int rx_frequency, PinName rx_pin, uint8_t new_rx_address, bool receive_all_packets)
 {
 	_is_initialized = false;
+	_is_suspended = false;
+	_clear_entropy_pool();
 	init(rx_frequency, rx_pin, new_rx_address, receive_all_packets);
 }
 
+ask_receiver_t::ask_receiver_t(int rx_frequency, PinName rx_pin, uint8_t new_rx_address, bool receive_all_packets, uint32_t flags)
+{
+	_is_initialized = false;
+	_is_suspended = false;
+	_clear_entropy_pool();
+	init(rx_frequency, rx_pin, new_rx_address, receive_all_packets, flags);
+}
+
 ask_receiver_t::~ask_receiver_t()
 {
 	init(0, NC, ASK_RECEIVER_BROADCAST_ADDRESS, false);
@@ -47,6 +63,11 @@ bool ask_receiver_t::init(int rx_frequency, PinName rx_pin, uint8_t new_rx_addre
 }
 
 bool ask_receiver_t::init(int rx_frequency, PinName rx_pin, uint8_t new_rx_address, bool receive_all_packets)
+{
+	return init(rx_frequency, rx_pin, new_rx_address, receive_all_packets, 0);
+}
+
+bool ask_receiver_t::init(int rx_frequency, PinName rx_pin, uint8_t new_rx_address, bool receive_all_packets, uint32_t flags)
 {
 	// shutdown if rx_frequency is 0
 	if (!rx_frequency)
@@ -55,8 +76,10 @@ bool ask_receiver_t::init(int rx_frequency, PinName rx_pin, uint8_t new_rx_addre
 		if (_is_initialized)
 		{
 			_rx_timer.detach();
+			_rx_resume_timeout.detach();
 			gpio_init_in(&_rx_pin, NC);
 			_is_initialized = false;
+			_is_suspended = false;
 		}
 		return true;
 	}
@@ -65,8 +88,8 @@ bool ask_receiver_t::init(int rx_frequency, PinName rx_pin, uint8_t new_rx_addre
 	if (rx_pin == NC)
 		return false;
 
-	// fail init if invalid frequency
-	if (!is_valid_frequency(rx_frequency))
+	// fail init if invalid frequency or flags
+	if (!is_valid_frequency(rx_frequency) || (flags & ~ASK_RECEIVER_VALID_FLAGS))
 		return false;
 
 	// only one receiver is allowed this one receiver is pointed by _ask_receiver
@@ -80,11 +103,14 @@ bool ask_receiver_t::init(int rx_frequency, PinName rx_pin, uint8_t new_rx_addre
 		if (_is_initialized)
 		{
 			_rx_timer.detach();
+			_rx_resume_timeout.detach();
 			gpio_init_in(&_rx_pin, NC);
 		}
+		_is_suspended = false;
 
 		_kermit = CRC16(0x1021, 0x0000, 0x0000, true, true, FAST_CRC);
 		rx_address = new_rx_address;
+		last_packet_time = 0;
 
 		// set receiver initialization parameters
 		_rx_frequency = rx_frequency;
@@ -96,7 +122,9 @@ bool ask_receiver_t::init(int rx_frequency, PinName rx_pin, uint8_t new_rx_addre
 		_rx_integrator = 0;
 		_rx_bits = 0;
 		_receive_all_packets = receive_all_packets;
+		_flags = flags;
 		_rx_active = 0;
+		_rx_burst_bit_count = 0;
 
 		// if reinitializing do not reinitialize rx entropy
 		if (!_is_initialized)
@@ -109,6 +137,16 @@ bool ask_receiver_t::init(int rx_frequency, PinName rx_pin, uint8_t new_rx_addre
 		_packets_dropped = 0;
 		_bytes_received = 0;
 		_bytes_dropped = 0;
+		_bytes_corrected = 0;
+		_packets_duplicate = 0;
+
+		// clear duplicate cache, header id 0 is never a duplicate
+		for (size_t i = 0; i != ASK_RECEIVER_DUPLICATE_CACHE_SIZE; ++i)
+		{
+			_duplicate_cache_tx_addresses[i] = ASK_RECEIVER_BROADCAST_ADDRESS;
+			_duplicate_cache_ids[i] = 0;
+		}
+		_duplicate_cache_next_index = 0;
 
 		// set ring buffer indices to 0
 		_rx_buffer_read_index = 0;
@@ -141,6 +179,16 @@ size_t ask_receiver_t::recv(uint8_t* tx_address, void* message_buffer, size_t me
 
 size_t ask_receiver_t::recv(uint8_t* rx_address, uint8_t* tx_address, void* message_buffer, size_t message_buffer_length)
 {
+	uint8_t ingnored[2];
+	return recv(rx_address, tx_address, &ingnored[0], &ingnored[1], message_buffer, message_buffer_length);
+}
+
+size_t ask_receiver_t::recv(uint8_t* rx_address, uint8_t* tx_address, uint8_t* header_id, uint8_t* header_flags, void* message_buffer, size_t message_buffer_length)
+{
+	// packets with forward error correction are checked after correcting them
+	if (_flags & ASK_RECEIVER_FLAG_FEC)
+		return _recv_fec_packet(rx_address, tx_address, header_id, header_flags, message_buffer, message_buffer_length);
+
 	if (_packets_available)
 	{
 		--_packets_available;
@@ -162,8 +210,11 @@ size_t ask_receiver_t::recv(uint8_t* rx_address, uint8_t* tx_address, void* mess
 		// read header from part
 		*tx_address = _read_byte_from_buffer();
 
-		// discard header id and flag parts they are ignored by this program
-		_discard_bytes_from_buffer(2);
+		// read header id part
+		*header_id = _read_byte_from_buffer();
+
+		// read header flags part
+		*header_flags = _read_byte_from_buffer();
 
 		// read message data to  buffer given by caller
 		for (uint8_t* i = (uint8_t*)message_buffer, *e = i + message_lenght; i != e; ++i)
@@ -171,6 +222,8 @@ size_t ask_receiver_t::recv(uint8_t* rx_address, uint8_t* tx_address, void* mess
 
 		// discard truncated message data and the crc it is already validated by the interrupt handler
 		_discard_bytes_from_buffer(message_truncate + 2);
+
+		last_packet_time = _read_packet_time_from_buffer();
 		return message_lenght;
 	}
 	return 0;
@@ -185,6 +238,7 @@ void ask_receiver_t::status(ask_receiver_status_t* current_status)
 		current_status->rx_address = rx_address;
 		current_status->initialized = true;
 		current_status->receive_all_packets = _receive_all_packets;
+		current_status->flags = _flags;
 		if (_rx_active)
 			current_status->active = true;
 		else
@@ -194,7 +248,10 @@ void ask_receiver_t::status(ask_receiver_status_t* current_status)
 		current_status->packets_dropped = _packets_dropped;
 		current_status->bytes_received = _bytes_received;
 		current_status->bytes_dropped = _bytes_dropped;
+		current_status->bytes_corrected = _bytes_corrected;
+		current_status->packets_duplicate = _packets_duplicate;
 		current_status->rx_entropy = rx_entropy;
+		current_status->suspended = _is_suspended;
 	}
 	else
 	{
@@ -203,16 +260,85 @@ void ask_receiver_t::status(ask_receiver_status_t* current_status)
 		current_status->rx_address = ASK_RECEIVER_BROADCAST_ADDRESS;
 		current_status->initialized = false;
 		current_status->receive_all_packets = false;
+		current_status->flags = 0;
 		current_status->active = false;
 		current_status->packets_available = 0;
 		current_status->packets_received = 0;
 		current_status->packets_dropped = 0;
 		current_status->bytes_received = 0;
 		current_status->bytes_dropped = 0;
+		current_status->bytes_corrected = 0;
+		current_status->packets_duplicate = 0;
 		current_status->rx_entropy = ~0;
+		current_status->suspended = false;
 	}
 }
 
+uint32_t ask_receiver_t::get_seed()
+{
+	// wait only if the receiver has not yet collected enough samples after its first initialization
+	if (_is_initialized)
+	{
+		resume();
+		while (!_entropy_pool_ready)
+			wait_us(1000000 / _rx_frequency);
+	}
+
+	// hash the pool with time of the call and the number of seeds given
+	uint32_t seed = _mix_seed(us_ticker_read() ^ ++_seed_count);
+	for (size_t i = 0; i != ASK_RECEIVER_ENTROPY_POOL_SIZE; ++i)
+		seed = _mix_seed(seed ^ _entropy_pool[i]);
+	seed = _mix_seed(seed ^ rx_entropy);
+
+	// feed the seed back to the pool, so consecutive seeds differ even without new samples
+	_entropy_pool[_seed_count & (ASK_RECEIVER_ENTROPY_POOL_SIZE - 1)] ^= seed;
+	return seed;
+}
+
+bool ask_receiver_t::suspend(uint32_t resume_time)
+{
+	// the resume time needs to be in the future
+	uint32_t delay = resume_time - us_ticker_read();
+	if (!_is_initialized || !delay || delay >= 0x80000000)
+		return false;
+
+	// stop sampling, packet that was being received is lost
+	_rx_timer.detach();
+	_rx_resume_timeout.detach();
+	if (_rx_active && !_packet_ignored)
+		_erase_current_packet();
+	_rx_active = 0;
+	_is_suspended = true;
+
+	_rx_resume_timeout.attach_us(&_rx_resume_handler, delay);
+	return true;
+}
+
+void ask_receiver_t::resume()
+{
+	if (!_is_suspended)
+		return;
+	_rx_resume_timeout.detach();
+	_resume_sampling();
+}
+
+void ask_receiver_t::_rx_resume_handler()
+{
+	_ask_receiver->_resume_sampling();
+}
+
+void ask_receiver_t::_resume_sampling()
+{
+	// the demodulator starts from beginning, because the samples before this are unknown
+	_rx_last_sample = 0;
+	_rx_ramp = 0;
+	_rx_integrator = 0;
+	_rx_bits = 0;
+	_rx_burst_bit_count = 0;
+	_is_suspended = false;
+	_rx_timer.attach(&_rx_interrupt_handler, 1.0f / (float)(_rx_frequency * ASK_RECEIVER_SAMPLERS_PER_BIT));
+}
+
 bool ask_receiver_t::is_valid_frequency(int frequency)
 {
 	static const int valid_frequencies[] = { 1000, 1250, 2500, 3125 };
@@ -235,6 +361,15 @@ void ask_receiver_t::_rx_interrupt_handler()
 	uint32_t rx_crc_msb = ((uint32_t)rx_sample ^ rx_crc) & 1;
 	_ask_receiver->rx_entropy = ~((rx_crc_msb << 31) | ((rx_crc >> 1) ^ (0x6DB88320 & (0 - rx_crc_msb))));
 
+	// every 32 samples rx_entropy and jitter of the interrupt timing are folded to next word of the entropy pool
+	if (!(++_ask_receiver->_entropy_sample_count & 0x1F))
+	{
+		uint32_t* pool_word = (uint32_t*)_ask_receiver->_entropy_pool + ((_ask_receiver->_entropy_sample_count >> 5) & (ASK_RECEIVER_ENTROPY_POOL_SIZE - 1));
+		*pool_word = ((*pool_word << 7) | (*pool_word >> 25)) ^ _ask_receiver->rx_entropy ^ us_ticker_read();
+		if (_ask_receiver->_entropy_sample_count == ASK_RECEIVER_ENTROPY_MINIMUM_SAMPLES)
+			_ask_receiver->_entropy_pool_ready = true;
+	}
+
 	// sum all samples till ramp reaches ASK_RECEIVER_RAMP_LENGTH
 	_ask_receiver->_rx_integrator += rx_sample;
 
@@ -269,39 +404,97 @@ void ask_receiver_t::_rx_interrupt_handler()
 		{
 			// if receiving a packet
 
+			// in scrambled NRZ mode every byte is 8 bits
+			bool scrambled_nrz = (_ask_receiver->_flags & ASK_RECEIVER_FLAG_SCRAMBLED_NRZ) != 0;
+
 			_ask_receiver->_rx_bit_count += 1;
-			if (_ask_receiver->_rx_bit_count == 12)
+			if (_ask_receiver->_rx_bit_count == (scrambled_nrz ? 8 : 12))
 			{
-				// when receive 12 bits (2 symbols)
+				// when receive 12 bits (2 symbols) or 8 scrambled bits
 
 				_ask_receiver->_rx_bit_count = 0;
 
-				// decode next byte from 2 received symbols
-				uint8_t received_byte = (_decode_symbol((uint8_t)(_ask_receiver->_rx_bits & 0x3F)) << 4) | _decode_symbol((uint8_t)(_ask_receiver->_rx_bits >> 6));
+				// decode next byte from 2 received symbols or descramble it from the last 8 received bits
+				uint8_t received_byte;
+				if (scrambled_nrz)
+					received_byte = (uint8_t)(_ask_receiver->_rx_bits >> 4) ^ ask_scrambler_sequence(&_ask_receiver->_rx_scrambler_state);
+				else
+					received_byte = (_decode_symbol((uint8_t)(_ask_receiver->_rx_bits & 0x3F)) << 4) | _decode_symbol((uint8_t)(_ask_receiver->_rx_bits >> 6));
+
+				if (_ask_receiver->_packet_ignored)
+				{
+					// in burst mode ignored packet is received to its end without storing it to stay synchronized with the next packet of the burst
+					_ask_receiver->_packet_received += 1;
+					if (_ask_receiver->_packet_received == _ask_receiver->_packet_length)
+					{
+						_ask_receiver->_rx_active = 0;
+						_ask_receiver->_rx_burst_bit_count = 12;
+					}
+					return;
+				}
 				
 				if (!_ask_receiver->_packet_received)
 				{
 					// first byte contains length of the packet
 
-					if (received_byte < 7 || (size_t)received_byte > _ask_receiver->_get_buffer_free_space())
+					if (_ask_receiver->_flags & ASK_RECEIVER_FLAG_FEC)
+					{
+						// with forward error correction the length is send three times and every bit of it is the majority of the copies
+						// the copies count the two extra length bytes, that are not stored to the buffer
+						if (_ask_receiver->_packet_length_copy_count != 2)
+						{
+							_ask_receiver->_packet_length_copies[_ask_receiver->_packet_length_copy_count++] = received_byte;
+							return;
+						}
+						uint8_t first_copy = _ask_receiver->_packet_length_copies[0];
+						uint8_t second_copy = _ask_receiver->_packet_length_copies[1];
+						uint8_t length = (first_copy & second_copy) | (first_copy & received_byte) | (second_copy & received_byte);
+						received_byte = (length > 2) ? length - 2 : 0;
+					}
+
+					if (received_byte < ((_ask_receiver->_flags & ASK_RECEIVER_FLAG_FEC) ? 7 + ASK_FEC_PARITY_SIZE : 7) || (size_t)received_byte + ASK_RECEIVER_PACKET_TIME_SIZE > _ask_receiver->_get_buffer_free_space())
 					{
 						// if invalid lenght or not enough space in buffer ignore this packet
 						_ask_receiver->_rx_active = 0;
 
 						_ask_receiver->_packets_dropped++;
 						if (received_byte > 6)
+						{
 							_ask_receiver->_bytes_dropped += (size_t)received_byte - 7;
+
+							// in burst mode the length is valid so the packet can be received to its end
+							if (_ask_receiver->_flags & ASK_RECEIVER_FLAG_BURST_MODE)
+							{
+								_ask_receiver->_rx_active = 1;
+								_ask_receiver->_packet_ignored = 1;
+								_ask_receiver->_packet_length = received_byte;
+								_ask_receiver->_packet_received = 1;
+							}
+						}
 						return;
 					}
 					_ask_receiver->_packet_length = received_byte;
 				}
-				else if (_ask_receiver->_packet_received == 1 && !_ask_receiver->_receive_all_packets)
+				else if (_ask_receiver->_packet_received == 1 && !_ask_receiver->_receive_all_packets && !(_ask_receiver->_flags & ASK_RECEIVER_FLAG_FEC))
 				{
 					// ignore the packets that are not send to this receiver
 					if (received_byte != ASK_RECEIVER_BROADCAST_ADDRESS && received_byte != _ask_receiver->rx_address)
 					{
-						_ask_receiver->_rx_active = 0;
-						_ask_receiver->_erase_current_packet();
+						_ask_receiver->_ignore_current_packet();
+						return;
+					}
+				}
+				else if (_ask_receiver->_packet_received == 2)
+					_ask_receiver->_packet_tx_address = received_byte;
+				else if (_ask_receiver->_packet_received == 3)
+				{
+					_ask_receiver->_packet_id = received_byte;
+
+					// drop the packet if it has same header id as the last valid packet from the same transmitter
+					if ((_ask_receiver->_flags & (ASK_RECEIVER_FLAG_DUPLICATE_FILTER | ASK_RECEIVER_FLAG_FEC)) == ASK_RECEIVER_FLAG_DUPLICATE_FILTER && _ask_receiver->_is_duplicate_packet(_ask_receiver->_packet_tx_address, received_byte))
+					{
+						_ask_receiver->_packets_duplicate++;
+						_ask_receiver->_ignore_current_packet();
 						return;
 					}
 				}
@@ -321,14 +514,25 @@ void ask_receiver_t::_rx_interrupt_handler()
 					// compare crc of the packet to calculated crc if the match the packet is valid
 					// if the packet is valid it will become readable to recv function
 					// if the packet is invalid it is erased
+					// packet with forward error correction is always readable to recv function, that corrects and checks it
 
+					// time of the end of the packet is written after the packet before it becomes readable
 					_ask_receiver->_packet_crc = ~_ask_receiver->_packet_crc;
-					if (_ask_receiver->_packet_crc == _ask_receiver->_packet_received_crc)
+					if (_ask_receiver->_flags & ASK_RECEIVER_FLAG_FEC)
+					{
+						_ask_receiver->_write_packet_time_to_buffer(us_ticker_read());
+						_ask_receiver->_packets_available += 1;
+					}
+					else if (_ask_receiver->_packet_crc == _ask_receiver->_packet_received_crc)
 					{
 						_ask_receiver->_packets_received++;
 						_ask_receiver->_bytes_received += (size_t)_ask_receiver->_packet_length - 7;
 
+						_ask_receiver->_write_packet_time_to_buffer(us_ticker_read());
 						_ask_receiver->_packets_available += 1;
+
+						if (_ask_receiver->_flags & ASK_RECEIVER_FLAG_DUPLICATE_FILTER)
+							_ask_receiver->_add_packet_to_duplicate_cache(_ask_receiver->_packet_tx_address, _ask_receiver->_packet_id);
 					}
 					else
 					{
@@ -340,23 +544,63 @@ void ask_receiver_t::_rx_interrupt_handler()
 
 					// stop receiving this packet
 					_ask_receiver->_rx_active = 0;
+
+					// in burst mode start symbol of the next packet may follow the packet
+					if (_ask_receiver->_flags & ASK_RECEIVER_FLAG_BURST_MODE)
+						_ask_receiver->_rx_burst_bit_count = 12;
 				}
 			}
 		}
-		else if (_ask_receiver->_rx_bits == ASK_RECEIVER_START_SYMBOL)
+		else
 		{
-			// if not receiving a packet and received the start symbol
-
-			_ask_receiver->_rx_active = 1;
-			_ask_receiver->_rx_bit_count = 0;
-			_ask_receiver->_packet_length = 0;
-			_ask_receiver->_packet_received = 0;
-			_ask_receiver->_packet_crc = 0xFFFF;
-			_ask_receiver->_packet_received_crc = 0;
+			// if not receiving a packet and received the start symbol begin receiving next packet
+			// in burst mode after a packet, the start symbol of the next packet is accepted only exactly after the packet
+			bool start_symbol_received = false;
+			if (_ask_receiver->_rx_burst_bit_count)
+			{
+				_ask_receiver->_rx_burst_bit_count -= 1;
+				start_symbol_received = !_ask_receiver->_rx_burst_bit_count && _ask_receiver->_rx_bits == ASK_RECEIVER_START_SYMBOL;
+			}
+			else
+				start_symbol_received = _ask_receiver->_rx_bits == ASK_RECEIVER_START_SYMBOL;
+
+			if (start_symbol_received)
+			{
+				_ask_receiver->_rx_active = 1;
+				_ask_receiver->_rx_bit_count = 0;
+				_ask_receiver->_rx_scrambler_state = ASK_SCRAMBLER_SEED;
+				_ask_receiver->_packet_ignored = 0;
+				_ask_receiver->_packet_length = 0;
+				_ask_receiver->_packet_length_copy_count = 0;
+				_ask_receiver->_packet_received = 0;
+				_ask_receiver->_packet_crc = 0xFFFF;
+				_ask_receiver->_packet_received_crc = 0;
+			}
 		}
 	}
 }
 
+void ask_receiver_t::_clear_entropy_pool()
+{
+	// entropy pool is collected only once for the receiver object, it is kept when the receiver is shutdown
+	for (size_t i = 0; i != ASK_RECEIVER_ENTROPY_POOL_SIZE; ++i)
+		_entropy_pool[i] = 0;
+	_entropy_sample_count = 0;
+	_entropy_pool_ready = false;
+	_seed_count = 0;
+}
+
+uint32_t ask_receiver_t::_mix_seed(uint32_t x)
+{
+	// 32 bit integer hash with good avalanche, every input bit affects every output bit
+	x ^= x >> 16;
+	x *= 0x7FEB352D;
+	x ^= x >> 15;
+	x *= 0x846CA68B;
+	x ^= x >> 16;
+	return x;
+}
+
 uint8_t ask_receiver_t::_decode_symbol(uint8_t _6bit_symbol)
 {
 	static const uint8_t symbol_table[16] = { 0x0D, 0x0E, 0x13, 0x15, 0x16, 0x19, 0x1A, 0x1C, 0x23, 0x25, 0x26, 0x29, 0x2A, 0x2C, 0x32, 0x34 };
@@ -391,6 +635,21 @@ void ask_receiver_t::_write_byte_to_buffer(uint8_t data)
 		_rx_buffer_write_index = 0;
 }
 
+void ask_receiver_t::_write_packet_time_to_buffer(uint32_t packet_time)
+{
+	// space for the time is reserved when the length of the packet is received
+	for (int i = 0; i != ASK_RECEIVER_PACKET_TIME_SIZE; ++i)
+		_write_byte_to_buffer((uint8_t)(packet_time >> (i << 3)));
+}
+
+uint32_t ask_receiver_t::_read_packet_time_from_buffer()
+{
+	uint32_t packet_time = 0;
+	for (int i = 0; i != ASK_RECEIVER_PACKET_TIME_SIZE; ++i)
+		packet_time |= (uint32_t)_read_byte_from_buffer() << (i << 3);
+	return packet_time;
+}
+
 void ask_receiver_t::_erase_current_packet()
 {
 	// erases the packet currently being received from the receivers buffer
@@ -401,6 +660,53 @@ void ask_receiver_t::_erase_current_packet()
 		_rx_buffer_write_index = write_index - _packet_received;
 }
 
+void ask_receiver_t::_ignore_current_packet()
+{
+	// erases the packet currently being received, the last received byte is not yet counted to the packet
+	_rx_active = 0;
+	_erase_current_packet();
+
+	// in burst mode the packet is received to its end without storing it to stay synchronized with the next packet of the burst
+	if (_flags & ASK_RECEIVER_FLAG_BURST_MODE)
+	{
+		_packet_ignored = 1;
+		_packet_received += 1;
+		if (_packet_received != _packet_length)
+			_rx_active = 1;
+		else
+			_rx_burst_bit_count = 12;
+	}
+}
+
+bool ask_receiver_t::_is_duplicate_packet(uint8_t tx_address, uint8_t header_id)
+{
+	if (!header_id)
+		return false;
+	for (size_t i = 0; i != ASK_RECEIVER_DUPLICATE_CACHE_SIZE; ++i)
+		if (_duplicate_cache_tx_addresses[i] == tx_address)
+			return _duplicate_cache_ids[i] == header_id;
+	return false;
+}
+
+void ask_receiver_t::_add_packet_to_duplicate_cache(uint8_t tx_address, uint8_t header_id)
+{
+	if (!header_id)
+		return;
+
+	// update header id of the transmitter if it is in the cache
+	for (size_t i = 0; i != ASK_RECEIVER_DUPLICATE_CACHE_SIZE; ++i)
+		if (_duplicate_cache_tx_addresses[i] == tx_address)
+		{
+			_duplicate_cache_ids[i] = header_id;
+			return;
+		}
+
+	// replace the oldest entry of the cache with the transmitter
+	_duplicate_cache_tx_addresses[_duplicate_cache_next_index] = tx_address;
+	_duplicate_cache_ids[_duplicate_cache_next_index] = header_id;
+	_duplicate_cache_next_index = (uint8_t)((_duplicate_cache_next_index + 1) % ASK_RECEIVER_DUPLICATE_CACHE_SIZE);
+}
+
 uint8_t ask_receiver_t::_read_byte_from_buffer()
 {
 	// the function assumes that threre is data available in the buffer
@@ -420,4 +726,76 @@ void ask_receiver_t::_discard_bytes_from_buffer(size_t size)
 		_rx_buffer_read_index = read_index + size - ASK_RECEIVER_BUFFER_SIZE;
 	else
 		_rx_buffer_read_index = read_index + size;
-}
\ No newline at end of file
+}
+
+size_t ask_receiver_t::_recv_fec_packet(uint8_t* rx_address, uint8_t* tx_address, uint8_t* header_id, uint8_t* header_flags, void* message_buffer, size_t message_buffer_length)
+{
+	uint8_t block[ASK_FEC_MAXIMUM_BLOCK_SIZE];
+	while (_packets_available)
+	{
+		--_packets_available;
+
+		// read the packet after the length byte to contiguous block for error correction
+		uint8_t packet_length = _read_byte_from_buffer();
+		size_t block_size = (size_t)packet_length - 1;
+		for (size_t i = 0; i != block_size; ++i)
+			block[i] = _read_byte_from_buffer();
+		uint32_t packet_time = _read_packet_time_from_buffer();
+		size_t message_lenght = block_size - 6 - ASK_FEC_PARITY_SIZE;
+
+		// correct the block and compare crc of the corrected packet to received crc
+		int bytes_corrected = ask_fec_decode(block, block_size);
+		bool valid_packet = false;
+		if (bytes_corrected != -1)
+		{
+			uint16_t crc = _kermit.fastCRC(0xFFFF, packet_length);
+			for (size_t i = 0; i != 4 + message_lenght; ++i)
+				crc = _kermit.fastCRC(crc, block[i]);
+			crc = ~crc;
+			valid_packet = crc == ((uint16_t)block[4 + message_lenght] | ((uint16_t)block[5 + message_lenght] << 8));
+		}
+		if (!valid_packet)
+		{
+			_packets_dropped++;
+			_bytes_dropped += message_lenght;
+			continue;
+		}
+
+		// ignore the packets that are not send to this receiver
+		if (!_receive_all_packets && block[0] != ASK_RECEIVER_BROADCAST_ADDRESS && block[0] != this->rx_address)
+			continue;
+
+		// drop the packet if it has same header id as the last valid packet from the same transmitter
+		if (_flags & ASK_RECEIVER_FLAG_DUPLICATE_FILTER)
+		{
+			if (_is_duplicate_packet(block[1], block[2]))
+			{
+				_packets_duplicate++;
+				continue;
+			}
+			_add_packet_to_duplicate_cache(block[1], block[2]);
+		}
+
+		_packets_received++;
+		_bytes_received += message_lenght;
+		_bytes_corrected += (size_t)bytes_corrected;
+
+		// truncate message to lenght of the buffer given by caller
+		if (message_lenght > message_buffer_length)
+			message_lenght = message_buffer_length;
+
+		// read header to, from, id and flags parts
+		*rx_address = block[0];
+		*tx_address = block[1];
+		*header_id = block[2];
+		*header_flags = block[3];
+		last_packet_time = packet_time;
+
+		// copy message data to buffer given by caller
+		for (size_t i = 0; i != message_lenght; ++i)
+			((uint8_t*)message_buffer)[i] = block[4 + i];
+
+		return message_lenght;
+	}
+	return 0;
+}
@@ -1,5 +1,5 @@
 /*
-	Mbed OS ASK receiver version 1.4.1 2018-08-01 by Santtu Nyman.
+	Mbed OS ASK receiver version 1.13.1 2026-10-19 by Santtu Nyman.
 	This file is part of mbed-os-ask "https://github.com/Santtu-Nyman/mbed-os-ask".
 
 	Description
@@ -7,6 +7,28 @@
 		The receiver can be used to communicate with RadioHead library.
 
 	Version history
+		version 1.13.1 2026-10-19
+			get_seed documents the seed of receiver that is not initialized.
+		version 1.13.0 2026-10-19
+			Default ASK_RECEIVER_BUFFER_SIZE increased to 512 bytes to fit packets of maximum size.
+		version 1.12.1 2026-10-19
+			Scrambler moved to ask_scrambler.h, that is shared with the transmitter.
+		version 1.12.0 2026-10-19
+			Length of packets with forward error correction is received three times and corrected by majority of the copies.
+		version 1.11.0 2026-10-19
+			Suspend and resume member functions added for duty cycling the receiver.
+		version 1.10.0 2026-10-19
+			Entropy pool and get_seed member function added.
+		version 1.9.0 2026-10-19
+			Receiver records the time of the end of each packet and last_packet_time member variable added.
+		version 1.8.0 2026-10-19
+			Overload of recv with header id and flags and duplicate filter flag added.
+		version 1.7.0 2026-10-19
+			Scrambled NRZ line code flag added.
+		version 1.6.0 2026-10-19
+			Forward error correction flag added.
+		version 1.5.0 2026-10-19
+			Added new overload for init and constructor with receiver flags and burst mode.
 		version 1.4.1 2018-08-01
 			rx_entropy bit mixing improved.
 		version 1.4.0 2018-07-19
@@ -40,25 +62,39 @@
 #define ASK_RECEIVER_H
 
 #define ASK_RECEIVER_VERSION_MAJOR 1
-#define ASK_RECEIVER_VERSION_MINOR 4
+#define ASK_RECEIVER_VERSION_MINOR 13
 #define ASK_RECEIVER_VERSION_PATCH 1
 
 #define ASK_RECEIVER_IS_VERSION_ATLEAST(h, m, l) ((((unsigned long)(h) << 16) | ((unsigned long)(m) << 8) | (unsigned long)(l)) <= ((ASK_RECEIVER_VERSION_MAJOR << 16) | (ASK_RECEIVER_VERSION_MINOR << 8) | ASK_RECEIVER_VERSION_PATCH))
 
 #include "mbed.h"
 #include "ask_CRC16.h"
+#include "ask_fec.h"
+#include "ask_scrambler.h"
 #include <stddef.h>
 #include <stdint.h>
 
 #ifndef ASK_RECEIVER_BUFFER_SIZE
-#define ASK_RECEIVER_BUFFER_SIZE 64
+#define ASK_RECEIVER_BUFFER_SIZE 512
+#endif
+#ifndef ASK_RECEIVER_DUPLICATE_CACHE_SIZE
+#define ASK_RECEIVER_DUPLICATE_CACHE_SIZE 8
 #endif
 #define ASK_RECEIVER_MAXIMUM_MESSAGE_SIZE 0xF8
 #define ASK_RECEIVER_BROADCAST_ADDRESS 0xFF
 #define ASK_RECEIVER_SAMPLERS_PER_BIT 8
+#define ASK_RECEIVER_PACKET_TIME_SIZE 4
+#define ASK_RECEIVER_ENTROPY_POOL_SIZE 4
+#define ASK_RECEIVER_ENTROPY_MINIMUM_SAMPLES 1024
 
 #define ASK_RECEIVER_START_SYMBOL 0xB38
 
+#define ASK_RECEIVER_FLAG_BURST_MODE 0x1
+#define ASK_RECEIVER_FLAG_FEC 0x2
+#define ASK_RECEIVER_FLAG_SCRAMBLED_NRZ 0x4
+#define ASK_RECEIVER_FLAG_DUPLICATE_FILTER 0x8
+#define ASK_RECEIVER_VALID_FLAGS (ASK_RECEIVER_FLAG_BURST_MODE | ASK_RECEIVER_FLAG_FEC | ASK_RECEIVER_FLAG_SCRAMBLED_NRZ | ASK_RECEIVER_FLAG_DUPLICATE_FILTER)
+
 #define ASK_RECEIVER_RAMP_LENGTH 160
 #define ASK_RECEIVER_RAMP_INCREMENT (ASK_RECEIVER_RAMP_LENGTH / ASK_RECEIVER_SAMPLERS_PER_BIT)
 #define ASK_RECEIVER_RAMP_TRANSITION (ASK_RECEIVER_RAMP_LENGTH / 2)
@@ -73,13 +109,17 @@ typedef struct ask_receiver_status_t
 	uint8_t rx_address;
 	bool initialized;
 	bool receive_all_packets;
+	uint32_t flags;
 	bool active;
 	int packets_available;
 	size_t packets_received;
 	size_t packets_dropped;
 	size_t bytes_received;
 	size_t bytes_dropped;
+	size_t bytes_corrected;
+	size_t packets_duplicate;
 	uint32_t rx_entropy;
+	bool suspended;
 } ask_receiver_status_t;
 
 class ask_receiver_t
@@ -89,6 +129,7 @@ class ask_receiver_t
 		ask_receiver_t(int rx_frequency, PinName rx_pin);
 		ask_receiver_t(int rx_frequency, PinName rx_pin, uint8_t new_rx_address);
 		ask_receiver_t(int rx_frequency, PinName rx_pin, uint8_t new_rx_address, bool receive_all_packets);
+		ask_receiver_t(int rx_frequency, PinName rx_pin, uint8_t new_rx_address, bool receive_all_packets, uint32_t flags);
 		// These constructors call init with same parameters.
 
 		~ask_receiver_t();
@@ -158,6 +199,49 @@ class ask_receiver_t
 				If the function succeeds, the return value is true and false on failure.
 		*/
 
+		bool init(int rx_frequency, PinName rx_pin, uint8_t new_rx_address, bool receive_all_packets, uint32_t flags);
+		/*
+			Descriptions
+				Re/initializes the receiver object with given parameters.
+				Re/initializing receiver object will fail if initialized receiver object already exists.
+				Value of rx_address is set to the new rx address.
+			Parameters
+				rx_frequency
+					The frequency of the receiver. This value is required to be valid frequency or 0, or the function fails.
+					Valid frequencies are 1000, 1250, 2500 and 3125.
+					If this parameter is 0 and the receiver is initialized it will shutdown.
+					If this parameter is 0 and the receiver is not initialized it will not initialize.
+					The receiver is not initialized after it is shutdown.
+				rx_pin
+					Mbed OS pin name for rx pin.
+				new_rx_address
+					rx address for the receiver.
+				receive_all_packets
+					If value of receive_all_packets is false receiver receives only packets that are send to broadcast address or receiver's rx address.
+					If value of receive_all_packets is true receiver receives all packets.
+				flags
+					Combination of receiver flags or 0. Other initialization functions set the flags to 0.
+					ASK_RECEIVER_FLAG_BURST_MODE
+						Receiver receives bursts send by transmitter with ASK_TRANSMITTER_FLAG_BURST_MODE.
+						After end of every packet the receiver stays synchronized and expects the start symbol of the next packet of the burst exactly after the packet.
+						Packets that are not received are received to their end without storing them to stay synchronized to the burst.
+					ASK_RECEIVER_FLAG_FEC
+						Receiver receives packets send by transmitter with ASK_TRANSMITTER_FLAG_FEC.
+						The interrupt handler stores packets without checking them and recv corrects errors of the packet by its Reed-Solomon parity before checking the crc and the rx address.
+						The length of the packet is received three times and every bit of it is the majority of the copies, so single erroneous copy of the length does not lose the packet.
+						Packets without the parity are dropped. Number of corrected bytes is counted to bytes_corrected of the receiver status.
+					ASK_RECEIVER_FLAG_SCRAMBLED_NRZ
+						Receiver receives packets send by transmitter with ASK_TRANSMITTER_FLAG_SCRAMBLED_NRZ.
+						Bytes of the packet after the start symbol are received as 8 scrambled bits instead of two 4b6b symbols.
+						Packets send with 4b6b symbols can not be received in this mode.
+					ASK_RECEIVER_FLAG_DUPLICATE_FILTER
+						Receiver remembers header id of the last valid packet from ASK_RECEIVER_DUPLICATE_CACHE_SIZE most recent transmitters.
+						Packet that has same tx address and header id as the remembered packet is dropped when its header id is received, before rest of it is written to the receiver's buffer.
+						Packets with header id 0 are never dropped as duplicates. Number of dropped duplicates is counted to packets_duplicate of the receiver status.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
 		size_t recv(void* message_buffer, size_t message_buffer_length);
 		/*
 			Description
@@ -221,6 +305,33 @@ class ask_receiver_t
 				If no packet is read it returns 0.
 		*/
 
+		size_t recv(uint8_t* rx_address, uint8_t* tx_address, uint8_t* header_id, uint8_t* header_flags, void* message_buffer, size_t message_buffer_length);
+		/*
+			Description
+				Function Reads packet from receiver's buffer if there are any available packets, if not function returns 0.
+				Receiver's interrupt handler writes packets that it receives to receiver's buffer.
+				The receiver does not receive any packets if it is not initialized.
+				If the packet is longer than the size of caller's buffer, this function truncates the packet by message_buffer_length parameter.
+			Parameters
+				rx_address
+					Pointer to variable that receives address of the receiver.
+				tx_address
+					Pointer to variable that receives address of the transmitter.
+				header_id
+					Pointer to variable that receives RadioHead header id of the packet.
+				header_flags
+					Pointer to variable that receives RadioHead header flags of the packet.
+				message_buffer
+					Pointer to buffer that receives packest data.
+				message_buffer_length
+					Size of buffer pointed by message_data.
+					maximum size of packet is ASK_RECEIVER_MAXIMUM_MESSAGE_SIZE.
+					passing 0 value to this parameter makes it impossible to determine if packet was read, this may be undesired behavior.
+			Return
+				If function reads a packet it returns size of the packet truncated to size of callers buffer.
+				If no packet is read it returns 0.
+		*/
+
 		void status(ask_receiver_status_t* current_status);
 		/*
 			Description
@@ -232,6 +343,46 @@ class ask_receiver_t
 				No return value.
 		*/
 
+		uint32_t get_seed();
+		/*
+			Description
+				Function returns random seed from the receiver's entropy pool.
+				The interrupt handler feeds the pool continuously with rx_entropy and jitter of the interrupt timing, so the seed is returned without waiting.
+				Only if the receiver has read less than ASK_RECEIVER_ENTROPY_MINIMUM_SAMPLES samples since its first initialization, the function waits until it has.
+				The pool is not cleared when the receiver is shutdown or reinitialized.
+				If the receiver is not initialized, the function does not wait and the seed is hashed from the pool as it is.
+				If the receiver has never been initialized, the pool is empty and the seed is only a hash of the time of the call and the number of seeds returned, so it is not random.
+			Parameters
+				This function has no parameters.
+			Return
+				Random 32 bit seed.
+		*/
+
+		bool suspend(uint32_t resume_time);
+		/*
+			Description
+				Function stops sampling the rx pin until given time, to save processor time and energy when the caller knows that no packets are coming.
+				Packets in the receiver's buffer are kept, but packet that is being received when this function is called is lost.
+				The receiver resumes sampling by itself at the resume time. If the receiver is already suspended, the new resume time replaces the old one.
+			Parameters
+				resume_time
+					Time when the receiver resumes sampling. The time is value of us_ticker_read in microseconds and it is required to be less than 2^31 microseconds in the future.
+			Return
+				If the receiver is suspended, the return value is true.
+				If the receiver is not initialized or the resume time is not in the future, the return value is false.
+		*/
+
+		void resume();
+		/*
+			Description
+				Function resumes sampling of suspended receiver immediately.
+				If the receiver is not suspended, this function does nothing.
+			Parameters
+				This function has no parameters.
+			Return
+				No return value.
+		*/
+
 		static bool is_valid_frequency(int frequency);
 		/*
 			Description
@@ -252,19 +403,36 @@ class ask_receiver_t
 		// Value of rx_entropy is mix of all samples that the receiver reads from rx pin.
 		// This variable is updated rx_frequency * ASK_RECEIVER_SAMPLERS_PER_BIT times every second by the Receiver's interrupt handler, while the receiver initialized.
 
+		uint32_t last_packet_time;
+		// Value of last_packet_time is us_ticker_read time of the end of the last packet returned by recv.
+		// The time is recorded by the interrupt handler when the packet is received, so it does not depend on when recv is called.
+		// Each packet in the receiver's buffer uses ASK_RECEIVER_PACKET_TIME_SIZE bytes for the time.
+
 	private :
 		static void _rx_interrupt_handler();
 		static uint8_t _decode_symbol(uint8_t _6bit_symbol);
+		static uint32_t _mix_seed(uint32_t x);
+		static void _rx_resume_handler();
+		void _resume_sampling();
+		void _clear_entropy_pool();
 		size_t _get_buffer_free_space();
 		void _write_byte_to_buffer(uint8_t data);
+		void _write_packet_time_to_buffer(uint32_t packet_time);
+		uint32_t _read_packet_time_from_buffer();
 		void _erase_current_packet();
+		void _ignore_current_packet();
+		bool _is_duplicate_packet(uint8_t tx_address, uint8_t header_id);
+		void _add_packet_to_duplicate_cache(uint8_t tx_address, uint8_t header_id);
 		uint8_t _read_byte_from_buffer();
 		void _discard_bytes_from_buffer(size_t size);
+		size_t _recv_fec_packet(uint8_t* rx_address, uint8_t* tx_address, uint8_t* header_id, uint8_t* header_flags, void* message_buffer, size_t message_buffer_length);
 
 		bool _is_initialized;
 		CRC16 _kermit;
 		gpio_t _rx_pin;
 		Ticker _rx_timer;
+		Timeout _rx_resume_timeout;
+		volatile bool _is_suspended;
 
 		volatile int _packets_available;
 		uint8_t _rx_last_sample;
@@ -272,16 +440,37 @@ class ask_receiver_t
 		uint8_t _rx_integrator;
 		unsigned int _rx_bits;
 		bool _receive_all_packets;
+		uint32_t _flags;
 		volatile uint8_t _rx_active;
 		uint8_t _rx_bit_count;
+		uint8_t _rx_scrambler_state;
+		uint8_t _rx_burst_bit_count;
+		uint8_t _packet_ignored;
 		uint8_t _packet_length;
+		uint8_t _packet_length_copy_count;
+		uint8_t _packet_length_copies[2];
 		uint8_t _packet_received;
+		uint8_t _packet_tx_address;
+		uint8_t _packet_id;
 		uint16_t _packet_crc;
 		uint16_t _packet_received_crc;
 		volatile size_t _packets_received;
 		volatile size_t _packets_dropped;
 		volatile size_t _bytes_received;
 		volatile size_t _bytes_dropped;
+		size_t _bytes_corrected;
+		volatile size_t _packets_duplicate;
+
+		// tx address and header id of the last valid packet from recent transmitters
+		uint8_t _duplicate_cache_tx_addresses[ASK_RECEIVER_DUPLICATE_CACHE_SIZE];
+		uint8_t _duplicate_cache_ids[ASK_RECEIVER_DUPLICATE_CACHE_SIZE];
+		uint8_t _duplicate_cache_next_index;
+
+		// entropy pool fed by the interrupt handler
+		volatile uint32_t _entropy_pool[ASK_RECEIVER_ENTROPY_POOL_SIZE];
+		volatile uint32_t _entropy_sample_count;
+		volatile bool _entropy_pool_ready;
+		uint32_t _seed_count;
 
 		// input ring buffer
 		volatile size_t _rx_buffer_read_index;
@@ -0,0 +1,21 @@
+/*
+	Mbed OS ASK scrambler version 1.0.0 2026-10-19 by Santtu Nyman.
+	This file is part of mbed-os-ask "https://github.com/Santtu-Nyman/mbed-os-ask".
+*/
+
+#include "ask_scrambler.h"
+
+uint8_t ask_scrambler_sequence(uint8_t* scrambler_state)
+{
+	// next 8 bits of the scrambling sequence generated by x^7 + x^4 + 1, first bit of the sequence is the lowest bit
+	uint8_t state = *scrambler_state;
+	uint8_t sequence = 0;
+	for (uint8_t i = 0; i != 8; ++i)
+	{
+		uint8_t bit = ((state >> 6) ^ (state >> 3)) & 1;
+		state = (uint8_t)(((state << 1) | bit) & 0x7F);
+		sequence |= (uint8_t)(bit << i);
+	}
+	*scrambler_state = state;
+	return sequence;
+}
@@ -0,0 +1,39 @@
+/*
+	Mbed OS ASK scrambler version 1.0.0 2026-10-19 by Santtu Nyman.
+	This file is part of mbed-os-ask "https://github.com/Santtu-Nyman/mbed-os-ask".
+
+	Description
+		7-bit additive scrambler x^7 + x^4 + 1 of the scrambled NRZ line code of ask transmitter and receiver.
+		The transmitter and the receiver reset the scrambler to ASK_SCRAMBLER_SEED at the first byte of every packet and xor every byte with next 8 bits of the sequence.
+
+	Version history
+		version 1.0.0 2026-10-19
+			First version.
+*/
+
+#ifndef ASK_SCRAMBLER_H
+#define ASK_SCRAMBLER_H
+
+#define ASK_SCRAMBLER_VERSION_MAJOR 1
+#define ASK_SCRAMBLER_VERSION_MINOR 0
+#define ASK_SCRAMBLER_VERSION_PATCH 0
+
+#define ASK_SCRAMBLER_IS_VERSION_ATLEAST(h, m, l) ((((unsigned long)(h) << 16) | ((unsigned long)(m) << 8) | (unsigned long)(l)) <= ((ASK_SCRAMBLER_VERSION_MAJOR << 16) | (ASK_SCRAMBLER_VERSION_MINOR << 8) | ASK_SCRAMBLER_VERSION_PATCH))
+
+#include <stdint.h>
+
+// initial state of the scrambler at the start of every packet
+#define ASK_SCRAMBLER_SEED 0x7F
+
+uint8_t ask_scrambler_sequence(uint8_t* scrambler_state);
+/*
+	Description
+		Generates next 8 bits of the scrambling sequence.
+	Parameters
+		scrambler_state
+			Pointer to the 7-bit state of the scrambler, that is updated by the function.
+	Return
+		Next 8 bits of the sequence, first bit of the sequence is the lowest bit.
+*/
+
+#endif
@@ -0,0 +1,200 @@
+/*
+	Mbed OS ASK SPI transmitter version 1.1.0 2026-10-19 by Santtu Nyman.
+	This file is part of mbed-os-ask "https://github.com/Santtu-Nyman/mbed-os-ask".
+*/
+
+#include "ask_spi_transmitter.h"
+#include <new>
+
+ask_spi_transmitter_t::ask_spi_transmitter_t()
+{
+	_is_initialized = false;
+	_transfer_active = false;
+}
+
+ask_spi_transmitter_t::ask_spi_transmitter_t(int tx_frequency, PinName tx_pin, PinName clock_pin)
+{
+	_is_initialized = false;
+	_transfer_active = false;
+	init(tx_frequency, tx_pin, clock_pin);
+}
+
+ask_spi_transmitter_t::ask_spi_transmitter_t(int tx_frequency, PinName tx_pin, PinName clock_pin, uint8_t new_tx_address)
+{
+	_is_initialized = false;
+	_transfer_active = false;
+	init(tx_frequency, tx_pin, clock_pin, new_tx_address);
+}
+
+ask_spi_transmitter_t::ask_spi_transmitter_t(int tx_frequency, PinName tx_pin, PinName clock_pin, uint8_t new_tx_address, int spi_frequency)
+{
+	_is_initialized = false;
+	_transfer_active = false;
+	init(tx_frequency, tx_pin, clock_pin, new_tx_address, spi_frequency);
+}
+
+ask_spi_transmitter_t::~ask_spi_transmitter_t()
+{
+	init(0, NC, NC, ASK_TRANSMITTER_BROADCAST_ADDRESS, 0);
+}
+
+bool ask_spi_transmitter_t::init(int tx_frequency, PinName tx_pin, PinName clock_pin)
+{
+	return init(tx_frequency, tx_pin, clock_pin, ASK_TRANSMITTER_BROADCAST_ADDRESS);
+}
+
+bool ask_spi_transmitter_t::init(int tx_frequency, PinName tx_pin, PinName clock_pin, uint8_t new_tx_address)
+{
+	return init(tx_frequency, tx_pin, clock_pin, new_tx_address, ASK_SPI_TRANSMITTER_DEFAULT_SPI_FREQUENCY);
+}
+
+bool ask_spi_transmitter_t::init(int tx_frequency, PinName tx_pin, PinName clock_pin, uint8_t new_tx_address, int spi_frequency)
+{
+	// fail init if invalid parameters and not shutting down
+	if (tx_frequency && (tx_pin == NC || clock_pin == NC || !ask_transmitter_t::is_valid_frequency(tx_frequency) ||
+		spi_frequency < ASK_SPI_TRANSMITTER_MINIMUM_SPI_FREQUENCY || spi_frequency % tx_frequency))
+		return false;
+
+	// if initialized let the current packet be send and release the SPI peripheral
+	if (_is_initialized)
+	{
+		_wait_for_transfer();
+		_spi->~SPI();
+		_is_initialized = false;
+	}
+
+	// shutdown if tx_frequency is 0
+	if (!tx_frequency)
+		return true;
+
+	tx_address = new_tx_address;
+
+	// set transmitter initialization parameters
+	_tx_frequency = tx_frequency;
+	_spi_frequency = spi_frequency;
+	_spi_bits_per_bit = spi_frequency / tx_frequency;
+	_tx_pin_name = tx_pin;
+	_clock_pin_name = clock_pin;
+
+	_packets_send = 0;
+	_bytes_send = 0;
+
+	// SPI peripheral sends 8 bits per transfer most significant bit first, which is the bit order of the rendered bitstream
+	_spi = new (_spi_storage) SPI(_tx_pin_name, NC, _clock_pin_name);
+	_spi->format(8, 0);
+	_spi->frequency(_spi_frequency);
+
+	_is_initialized = true;
+	return true;
+}
+
+bool ask_spi_transmitter_t::send(uint8_t rx_address, const void* message_data, size_t message_byte_length)
+{
+	if (message_byte_length > ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE || !_is_initialized)
+		return false;
+
+	// the bitstream buffer is used by the previous packet until it is send
+	_wait_for_transfer();
+
+	size_t bit_count = ask_transmitter_t::render(rx_address, tx_address, message_data, message_byte_length, _bitstream, sizeof(_bitstream));
+	if (!bit_count)
+		return false;
+
+	// every bit of the bitstream is repeated for the SPI clock cycles of the bit period and the packet is send in chunks oversampled from the bitstream
+	// the bitstream ends with low bits, so padding bits of the last byte keep the output low
+	size_t spi_byte_count = ((bit_count * (size_t)_spi_bits_per_bit) + 7) / 8;
+	for (size_t spi_byte_offset = 0, chunk = 0; spi_byte_offset != spi_byte_count; chunk ^= 1)
+	{
+		size_t chunk_size = (spi_byte_count - spi_byte_offset < ASK_SPI_TRANSMITTER_CHUNK_SIZE) ? (spi_byte_count - spi_byte_offset) : ASK_SPI_TRANSMITTER_CHUNK_SIZE;
+		_oversample_bitstream(_chunks[chunk], chunk_size, spi_byte_offset * 8, bit_count);
+
+#if DEVICE_SPI_ASYNCH
+		// the chunk is oversampled while the previous chunk is being send
+		_wait_for_transfer();
+		_transfer_active = true;
+		if (_spi->transfer((const uint8_t*)_chunks[chunk], (int)chunk_size, (uint8_t*)0, 0, callback(this, &ask_spi_transmitter_t::_transfer_complete), SPI_EVENT_COMPLETE))
+		{
+			_transfer_active = false;
+			return false;
+		}
+#else
+		_spi->write((const char*)_chunks[chunk], (int)chunk_size, (char*)0, 0);
+#endif
+
+		spi_byte_offset += chunk_size;
+	}
+
+	++_packets_send;
+	_bytes_send += message_byte_length;
+
+	return true;
+}
+
+bool ask_spi_transmitter_t::send(const void* message_data, size_t message_byte_length)
+{
+	return send(ASK_TRANSMITTER_BROADCAST_ADDRESS, message_data, message_byte_length);
+}
+
+void ask_spi_transmitter_t::status(ask_spi_transmitter_status_t* current_status)
+{
+	if (_is_initialized)
+	{
+		current_status->tx_frequency = _tx_frequency;
+		current_status->spi_frequency = _spi_frequency;
+		current_status->tx_pin = _tx_pin_name;
+		current_status->clock_pin = _clock_pin_name;
+		current_status->tx_address = tx_address;
+		current_status->initialized = true;
+		current_status->active = _transfer_active;
+		current_status->packets_send = _packets_send;
+		current_status->bytes_send = _bytes_send;
+	}
+	else
+	{
+		current_status->tx_frequency = 0;
+		current_status->spi_frequency = 0;
+		current_status->tx_pin = NC;
+		current_status->clock_pin = NC;
+		current_status->tx_address = ASK_TRANSMITTER_BROADCAST_ADDRESS;
+		current_status->initialized = false;
+		current_status->active = false;
+		current_status->packets_send = 0;
+		current_status->bytes_send = 0;
+	}
+}
+
+void ask_spi_transmitter_t::_wait_for_transfer()
+{
+	// wait for the SPI peripheral to finish sending the bitstream
+	while (_transfer_active)
+		continue;
+}
+
+void ask_spi_transmitter_t::_transfer_complete(int event)
+{
+	// called from interrupt when the chunk is send
+	_transfer_active = false;
+}
+
+void ask_spi_transmitter_t::_oversample_bitstream(uint8_t* chunk, size_t chunk_size, size_t first_spi_bit, size_t bit_count)
+{
+	// every bit of the bitstream is repeated _spi_bits_per_bit times and SPI bits after the end of the bitstream are low
+	size_t bit_index = first_spi_bit / (size_t)_spi_bits_per_bit;
+	int bit_repeat_count = _spi_bits_per_bit - (int)(first_spi_bit % (size_t)_spi_bits_per_bit);
+	for (size_t i = 0; i != chunk_size; ++i)
+	{
+		uint8_t spi_byte = 0;
+		for (int j = 0; j != 8; ++j)
+		{
+			spi_byte <<= 1;
+			if (bit_index < bit_count)
+				spi_byte |= (_bitstream[bit_index >> 3] >> (7 - (bit_index & 7))) & 1;
+			if (!--bit_repeat_count)
+			{
+				++bit_index;
+				bit_repeat_count = _spi_bits_per_bit;
+			}
+		}
+		chunk[i] = spi_byte;
+	}
+}
@@ -0,0 +1,224 @@
+/*
+	Mbed OS ASK SPI transmitter version 1.1.0 2026-10-19 by Santtu Nyman.
+	This file is part of mbed-os-ask "https://github.com/Santtu-Nyman/mbed-os-ask".
+
+	Description
+		ASK transmitter for Mbed OS that sends packets by clocking them out of SPI MOSI pin.
+		Whole packet is rendered to a bitstream by ask_transmitter_t::render and the SPI peripheral sends it.
+		SPI peripherals can not run at the bit rates of the transmitter, so the SPI clock is a multiple of the bit rate and every bit of the bitstream is repeated for the SPI clock cycles of the bit period.
+		The transmitter does not use interrupt per bit like ask_transmitter_t, so other interrupts do not distort the waveform.
+		If the target supports asynchronous SPI the bitstream is send by DMA in chunks and send returns when the last chunk is started.
+		The transmitter can be used to communicate with RadioHead library.
+
+	Version history
+		version 1.1.0 2026-10-19
+			SPI clock frequency is a multiple of the bit rate and the bitstream is oversampled to it.
+		version 1.0.0 2026-10-19
+			First version.
+*/
+
+#ifndef ASK_SPI_TRANSMITTER_H
+#define ASK_SPI_TRANSMITTER_H
+
+#define ASK_SPI_TRANSMITTER_VERSION_MAJOR 1
+#define ASK_SPI_TRANSMITTER_VERSION_MINOR 1
+#define ASK_SPI_TRANSMITTER_VERSION_PATCH 0
+
+#define ASK_SPI_TRANSMITTER_IS_VERSION_ATLEAST(h, m, l) ((((unsigned long)(h) << 16) | ((unsigned long)(m) << 8) | (unsigned long)(l)) <= ((ASK_SPI_TRANSMITTER_VERSION_MAJOR << 16) | (ASK_SPI_TRANSMITTER_VERSION_MINOR << 8) | ASK_SPI_TRANSMITTER_VERSION_PATCH))
+
+#include "mbed.h"
+#include "ask_transmitter.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef ASK_SPI_TRANSMITTER_BUFFER_SIZE
+#define ASK_SPI_TRANSMITTER_BUFFER_SIZE ASK_TRANSMITTER_RENDER_BUFFER_SIZE(ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE)
+#endif
+#ifndef ASK_SPI_TRANSMITTER_CHUNK_SIZE
+#define ASK_SPI_TRANSMITTER_CHUNK_SIZE 64
+#endif
+#ifndef ASK_SPI_TRANSMITTER_DEFAULT_SPI_FREQUENCY
+#define ASK_SPI_TRANSMITTER_DEFAULT_SPI_FREQUENCY 250000
+#endif
+#ifndef ASK_SPI_TRANSMITTER_MINIMUM_SPI_FREQUENCY
+#define ASK_SPI_TRANSMITTER_MINIMUM_SPI_FREQUENCY 100000
+#endif
+
+typedef struct ask_spi_transmitter_status_t
+{
+	int tx_frequency;
+	int spi_frequency;
+	PinName tx_pin;
+	PinName clock_pin;
+	uint8_t tx_address;
+	bool initialized;
+	bool active;
+	size_t packets_send;
+	size_t bytes_send;
+} ask_spi_transmitter_status_t;
+
+class ask_spi_transmitter_t
+{
+	public :
+		ask_spi_transmitter_t();
+
+		ask_spi_transmitter_t(int tx_frequency, PinName tx_pin, PinName clock_pin);
+		ask_spi_transmitter_t(int tx_frequency, PinName tx_pin, PinName clock_pin, uint8_t new_tx_address);
+		ask_spi_transmitter_t(int tx_frequency, PinName tx_pin, PinName clock_pin, uint8_t new_tx_address, int spi_frequency);
+		// These constructors call init with same parameters.
+
+		~ask_spi_transmitter_t();
+
+		bool init(int tx_frequency, PinName tx_pin, PinName clock_pin);
+		/*
+			Description
+				Initializes the transmitter object with given parameters. If the transmitter is already initialized it is reinitialized with the new parameters.
+				The tx address of the transmitter is set to ASK_TRANSMITTER_BROADCAST_ADDRESS.
+				Unlike ask_transmitter_t, multiple SPI transmitters can be initialized at the same time.
+				The SPI clock frequency is set to ASK_SPI_TRANSMITTER_DEFAULT_SPI_FREQUENCY.
+				Value of tx_address is set to the new tx address.
+			Parameters
+				tx_frequency
+					The frequency of the transmitter. This value is required to be valid frequency or 0, or the function fails.
+					Valid frequencies are same as for ask_transmitter_t.
+					If this parameter is 0 and the transmitter is initialized it will shutdown.
+					If this parameter is 0 and the transmitter is not initialized it will not be initialized.
+					The transmitter is not initialized after it is shutdown.
+				tx_pin
+					Mbed OS pin name for tx pin. This pin needs to be MOSI pin of SPI peripheral.
+				clock_pin
+					Mbed OS pin name for SCLK pin of the same SPI peripheral. The clock is not needed by the radio, but SPI peripheral requires it.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
+		bool init(int tx_frequency, PinName tx_pin, PinName clock_pin, uint8_t new_tx_address);
+		/*
+			Description
+				Initializes the transmitter object with given parameters. If the transmitter is already initialized it is reinitialized with the new parameters.
+				Unlike ask_transmitter_t, multiple SPI transmitters can be initialized at the same time.
+				The SPI clock frequency is set to ASK_SPI_TRANSMITTER_DEFAULT_SPI_FREQUENCY.
+				Value of tx_address is set to the new tx address.
+			Parameters
+				tx_frequency
+					The frequency of the transmitter. This value is required to be valid frequency or 0, or the function fails.
+					Valid frequencies are same as for ask_transmitter_t.
+					If this parameter is 0 and the transmitter is initialized it will shutdown.
+					If this parameter is 0 and the transmitter is not initialized it will not be initialized.
+					The transmitter is not initialized after it is shutdown.
+				tx_pin
+					Mbed OS pin name for tx pin. This pin needs to be MOSI pin of SPI peripheral.
+				clock_pin
+					Mbed OS pin name for SCLK pin of the same SPI peripheral. The clock is not needed by the radio, but SPI peripheral requires it.
+				new_tx_address
+					tx address for the transmitter.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
+		bool init(int tx_frequency, PinName tx_pin, PinName clock_pin, uint8_t new_tx_address, int spi_frequency);
+		/*
+			Description
+				Initializes the transmitter object with given parameters. If the transmitter is already initialized it is reinitialized with the new parameters.
+				Unlike ask_transmitter_t, multiple SPI transmitters can be initialized at the same time.
+				Value of tx_address is set to the new tx address.
+			Parameters
+				tx_frequency
+					The frequency of the transmitter. This value is required to be valid frequency or 0, or the function fails.
+					Valid frequencies are same as for ask_transmitter_t.
+					If this parameter is 0 and the transmitter is initialized it will shutdown.
+					If this parameter is 0 and the transmitter is not initialized it will not be initialized.
+					The transmitter is not initialized after it is shutdown.
+				tx_pin
+					Mbed OS pin name for tx pin. This pin needs to be MOSI pin of SPI peripheral.
+				clock_pin
+					Mbed OS pin name for SCLK pin of the same SPI peripheral. The clock is not needed by the radio, but SPI peripheral requires it.
+				new_tx_address
+					tx address for the transmitter.
+				spi_frequency
+					Clock frequency of the SPI peripheral. Every bit of the packet is repeated spi_frequency / tx_frequency times.
+					This value is required to be a multiple of tx_frequency and at least ASK_SPI_TRANSMITTER_MINIMUM_SPI_FREQUENCY.
+					Mbed OS uses the nearest clock frequency that the SPI peripheral of the target can generate, so this value needs to be exactly one of them or the bit rate is wrong.
+					ASK_SPI_TRANSMITTER_DEFAULT_SPI_FREQUENCY is a multiple of all valid transmitter frequencies.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
+		bool send(uint8_t rx_address, const void* message_data, size_t message_byte_length);
+		/*
+			Description
+				Renders packet with given message to the bitstream buffer of the transmitter and sends it by SPI.
+				The bitstream is oversampled to the SPI clock in chunks of ASK_SPI_TRANSMITTER_CHUNK_SIZE bytes.
+				If the target supports asynchronous SPI the next chunk is prepared while the previous chunk is being send and this function returns when the last chunk is started.
+				If the target does not support asynchronous SPI this function blocks until the packet is send.
+				This function will block, if the previous packet is still being send.
+				The transmitter is required to be initialized or this function will fail.
+			Parameters
+				rx_address
+					Address of the receiver.
+				message_data
+					Pointer to the data to by send.
+				message_byte_length
+					The number of bytes to be send.
+					maximum value for this parameter is ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
+		bool send(const void* message_data, size_t message_byte_length);
+		/*
+			Description
+				Renders packet with given message to the bitstream buffer of the transmitter and sends it by SPI like the other send function.
+				Packet is send to the broadcast address.
+				The transmitter is required to be initialized or this function will fail.
+			Parameters
+				message_data
+					Pointer to the data to by send.
+				message_byte_length
+					The number of bytes to be send.
+					maximum value for this parameter is ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
+		void status(ask_spi_transmitter_status_t* current_status);
+		/*
+			Description
+				Function queries the current status of the transmitter.
+			Parameters
+				current_status
+					Pointer to variable that receives current stutus of the transmitter.
+			Return
+				No return value.
+		*/
+
+		volatile uint8_t tx_address;
+		// Value of tx_address specifies address of the transmitter.
+
+	private :
+		void _wait_for_transfer();
+		void _transfer_complete(int event);
+		void _oversample_bitstream(uint8_t* chunk, size_t chunk_size, size_t first_spi_bit, size_t bit_count);
+
+		bool _is_initialized;
+		SPI* _spi;
+		uint32_t _spi_storage[(sizeof(SPI) + sizeof(uint32_t) - 1) / sizeof(uint32_t)];
+		volatile bool _transfer_active;
+		size_t _packets_send;
+		size_t _bytes_send;
+		uint8_t _bitstream[ASK_SPI_TRANSMITTER_BUFFER_SIZE];
+		uint8_t _chunks[2][ASK_SPI_TRANSMITTER_CHUNK_SIZE];
+
+		// transmitter initialization parameters
+		int _tx_frequency;
+		int _spi_frequency;
+		int _spi_bits_per_bit;
+		PinName _tx_pin_name;
+		PinName _clock_pin_name;
+
+		// No copying object of this type!
+		ask_spi_transmitter_t(const ask_spi_transmitter_t&);
+		ask_spi_transmitter_t& operator=(const ask_spi_transmitter_t&);
+};
+
+#endif
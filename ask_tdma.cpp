@@ -1,36 +1,113 @@
 /*
-	Mbed OS ASK TDMA version 1.0.0 2018-08-09 by Santtu Nyman.
+	Mbed OS ASK TDMA version 1.23.5 2026-10-19 by Santtu Nyman.
 	This file is part of mbed-os-ask "https://github.com/Santtu-Nyman/mbed-os-ask".
 */
 
 #include "ask_tdma.h"
+#include <math.h>
 
 #define ASK_TDMA_SYNCHRONIZATION_MESSAGE 0x1
 #define ASK_TDMA_JOIN_MESSAGE 0x2
 #define ASK_TDMA_LEAVE_MESSAGE 0x4
 #define ASK_TDMA_TRANSFER_MESSAGE 0x8
+#define ASK_TDMA_KEEPALIVE_MESSAGE 0x3
+#define ASK_TDMA_SEQUENCED_DATA_MESSAGE 0x5
+#define ASK_TDMA_ACKNOWLEDGEMENT_MESSAGE 0x6
+
+// express message is whole transfer in single packet, size of the message is size of the packet without the header
+#define ASK_TDMA_EXPRESS_MESSAGE 0x7
+
+// extended synchronization message has parameter byte after the header of synchronization message and the identity of the accepted join request after it if the join bit is set, renames or slot map follow them.
+// lowest 3 bits of the parameter byte are the number of join slots minus one, bit 3 marks slot map and upper 4 bits are the data slot of the accepted join request in message with slot map
+#define ASK_TDMA_EXTENDED_SYNCHRONIZATION_MESSAGE 0x9
+#define ASK_TDMA_SLOT_MAP_FLAG 0x8
+
+// slot map has address of every data slot followed by lengths of the data slots in 4 bit fields, first data slot in the lower bits
+#define ASK_TDMA_SLOT_MAP_SIZE(data_slot_count) ((int)(data_slot_count) + (((int)(data_slot_count) + 1) >> 1))
+
+// bit 4 of transfer message marks reliable transfer, it has chunk size as fifth byte
+#define ASK_TDMA_RELIABLE_TRANSFER_FLAG 0x10
 #define ASK_TDMA_DATA_MESSAGE 0x0
 
 // multiplier for calculating timeouts for operations
 #define ASK_TDMA_TIMEOUT_MULTIPLIER 4
 
-#define ASK_TDMA_MAXIMUM_FRAME_LENGTH ((132 + 26 * 12) + (132 + 1 * 12 + 6) + ((16 * 15) * (132 + 16 * 12 + 6)))
+// number of frames between keepalive messages of client in session. base station sets usage of the data slot to maximum on keepalive, so this needs to be less than ASK_TDMA_SLOT_USAGE_MAXIMUM
+#define ASK_TDMA_KEEPALIVE_INTERVAL 8
+
+// async client waits this many milliseconds before joining again after failure that did not wait for the network, the delay doubles after every failure up to the maximum
+#define ASK_TDMA_ASYNC_MINIMUM_RETRY_DELAY 100
+#define ASK_TDMA_ASYNC_MAXIMUM_RETRY_DELAY 1600
+
+// size of acknowledgement window of reliable transfer in chunks, bitmap of the window is send in acknowledgement messages
+#define ASK_TDMA_ACKNOWLEDGEMENT_WINDOW_SIZE 32
+
+// number of frames the receiver of reliable transfer keeps sending final acknowledgement, in case the sender does not receive it
+#define ASK_TDMA_FINAL_ACKNOWLEDGEMENT_COUNT 3
+
+// clock ratio of the client and the base station is estimated with regression over this many frames, older frames are forgotten exponentially
+#define ASK_TDMA_CLOCK_ESTIMATE_WINDOW 32
+
+// estimated clock ratio is used for scheduling after this many frames
+#define ASK_TDMA_CLOCK_MINIMUM_SAMPLES 4
+
+// clock drift larger than this is assumed to be error, 1000 ppm
+#define ASK_TDMA_CLOCK_MAXIMUM_DRIFT 0.001
+
+// frame intervals that differ more than the maximum drift and this many bits from estimate are not used for the estimate
+#define ASK_TDMA_CLOCK_MAXIMUM_ERROR_BITS 16
+
+// frame lengths need to vary this many bits to estimate constant frame overhead of the base station
+#define ASK_TDMA_CLOCK_MINIMUM_SPREAD_BITS 64
+
+// in low power mode the receiver wakes up this many bits before the predicted start of the next frame synchronization packet, in addition to four times the jitter of the clock estimate
+#define ASK_TDMA_LOW_POWER_WAKEUP_MARGIN 64
+
+// the receiver is not suspended for shorter time than this many bits
+#define ASK_TDMA_LOW_POWER_MINIMUM_SLEEP 256
+
+// join request is send this many bits after the beginning of its join slot. the guard interval gives the client time to process the frame synchronization message before the first join slot
+// and keeps error of the client's clock estimate from making join requests of adjacent join slots overlap
+#define ASK_TDMA_JOIN_SLOT_GUARD_LENGTH 16
+
+// length of join slot in bits. one join request of two bytes is send in each join slot after the guard interval
+#define ASK_TDMA_JOIN_SLOT_LENGTH (ASK_TDMA_JOIN_SLOT_GUARD_LENGTH + 132 + 2 * 12 + 6)
+
+// length of all join slots of frame in bits. base station that does not send extended synchronization messages has single join slot for join request of one byte
+#define ASK_TDMA_JOIN_SLOTS_LENGTH(join_slot_count) ((join_slot_count) ? (int)(join_slot_count) * ASK_TDMA_JOIN_SLOT_LENGTH : (132 + 1 * 12 + 6))
+
+// frame synchronization message is used for scheduling its frame only if it ended less than this many bits ago. it is the length of the shortest join slots of any network, so the first data slot of the frame has not begun
+#define ASK_TDMA_SYNCHRONIZATION_MAXIMUM_AGE ASK_TDMA_JOIN_SLOTS_LENGTH(0)
+
+// clients that fail to join wait random number of frames below two to the power of failed join requests, up to this exponent
+#define ASK_TDMA_JOIN_MAXIMUM_BACKOFF_EXPONENT 7
+
+// length of data packet in bits. preamble, start symbol, packet header and crc 132 bits, 12 bits per message byte and 6 low bits after the packet
+#define ASK_TDMA_DATA_PACKET_LENGTH(data_packet_size) (132 + (int)(data_packet_size) * 12 + 6)
+
+// clients schedule all data packets of their data slot at once, so data slot can not have more packets than fit in the scheduled packet buffer of the transmitter
+#define ASK_TDMA_MAXIMUM_SCHEDULED_DATA_SLOT_LENGTH(data_packet_size) ((ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE - 1) / ASK_TRANSMITTER_SCHEDULED_PACKET_SIZE(data_packet_size))
+
+#define ASK_TDMA_MAXIMUM_FRAME_LENGTH ((132 + 26 * 12) + (ASK_TDMA_MAXIMUM_JOIN_SLOT_COUNT * ASK_TDMA_JOIN_SLOT_LENGTH) + ((16 * 15) * ASK_TDMA_DATA_PACKET_LENGTH(ASK_TDMA_MAXIMUM_DATA_PACKET_SIZE)))
 
 // nice value for assuming time stuff
-#define ASK_TDMA_ASSUMED_MAXIMUM_FRAME_LENGTH ((132 + 26 * 12) + (132 + 1 * 12 + 6) + ((16 * ASK_TDMA_TIMEOUT_MULTIPLIER) * (132 + 16 * 12 + 6)))
+#define ASK_TDMA_ASSUMED_MAXIMUM_FRAME_LENGTH(data_packet_size) ((132 + 26 * 12) + (ASK_TDMA_MAXIMUM_JOIN_SLOT_COUNT * ASK_TDMA_JOIN_SLOT_LENGTH) + ((16 * ASK_TDMA_TIMEOUT_MULTIPLIER) * ASK_TDMA_DATA_PACKET_LENGTH(data_packet_size)))
+
+// data packet sizes of the network, index of the size is send in the upper 3 bits of the second byte of frame synchronization message
+static const uint8_t data_packet_sizes[8] = { ASK_TDMA_DEFAULT_DATA_PACKET_SIZE, 32, 48, 64, 96, 128, 192, ASK_TDMA_MAXIMUM_DATA_PACKET_SIZE };
+
+static bool is_supported_data_packet_size(size_t data_packet_size)
+{
+	// data packet needs to fit in the receiver's buffer with the 7 byte packet overhead and the packet time and it needs to fit in the transmitter's scheduled packet buffer
+	return 7 + data_packet_size + ASK_RECEIVER_PACKET_TIME_SIZE <= ASK_RECEIVER_BUFFER_SIZE - 1 && data_packet_size <= ASK_TRANSMITTER_MAXIMUM_SCHEDULED_MESSAGE_SIZE;
+}
 
 static uint32_t initialize_xorshift32(ask_receiver_t* receiver)
 {
-	// initializes xorshift32 state from rx entropy
-	ask_receiver_status_t status;
-	receiver->status(&status);
+	// initializes xorshift32 state from receiver's entropy pool, it waits only when the receiver is used first time
 	uint32_t seed = 0;
 	while (!seed)
-	{
-		// wait for atleast 128 * receiver's samples per bit samples.
-		wait_us(128000000 / status.rx_frequency);
-		seed = receiver->rx_entropy ^ (uint32_t)time(0);
-	}
+		seed = receiver->get_seed() ^ (uint32_t)time(0);
 	return seed;
 }
 
@@ -43,6 +120,54 @@ static uint32_t xorshift32(uint32_t state)
 	return state;
 }
 
+static int get_join_request_time(int join_slot_count, int elapsed_bits, bool join_request_failed, int* join_requests_failed, int* backoff_frames, uint32_t* xorshift32_state, uint8_t* join_identity)
+{
+	// decides the join request of the client for the current frame after its frame synchronization message was processed elapsed_bits after the beginning of the frame.
+	// returns time of the join request in bits from the beginning of the frame or -1 if the client does not send join request in this frame
+
+	// binary exponential backoff spreads the join requests of many clients over more frames after every failed join request
+	if (join_request_failed)
+	{
+		if (*join_requests_failed < ASK_TDMA_JOIN_MAXIMUM_BACKOFF_EXPONENT)
+			++*join_requests_failed;
+		*xorshift32_state = xorshift32(*xorshift32_state);
+		*backoff_frames = (int)(*xorshift32_state & ((1 << *join_requests_failed) - 1));
+	}
+
+	if (*backoff_frames)
+	{
+		--*backoff_frames;
+		return -1;
+	}
+
+	// join request is send in random join slot. its identity is the join slot in the lowest 3 bits and random nonce from 1 to 31 in the upper bits, the base station sends it back when it accepts the request.
+	// join request to base station with single join slot of one byte has no identity
+	*xorshift32_state = xorshift32(*xorshift32_state);
+	uint8_t join_slot = join_slot_count ? (uint8_t)(*xorshift32_state % (uint32_t)join_slot_count) : 0;
+	*join_identity = (uint8_t)((1 + ((*xorshift32_state >> 8) % 31)) << 3) | join_slot;
+	if (!join_slot_count)
+		return 0;
+
+	// join request that would be send late overlaps the next join slot, so the client waits for the next frame if the time of its join request has already passed.
+	// the frame does not count as failed join request
+	int join_request_time = (int)join_slot * ASK_TDMA_JOIN_SLOT_LENGTH + ASK_TDMA_JOIN_SLOT_GUARD_LENGTH;
+	return (elapsed_bits < join_request_time) ? join_request_time : -1;
+}
+
+static uint8_t get_synchronization_header_size(const uint8_t* data, size_t size)
+{
+	// returns size of the frame synchronization message before the renames or the slot map, 0 if the message is not valid frame synchronization message
+	if (size > 1 && (data[0] & 0xF) == ASK_TDMA_SYNCHRONIZATION_MESSAGE)
+		return 2;
+	if (size > 2 && (data[0] & 0xF) == ASK_TDMA_EXTENDED_SYNCHRONIZATION_MESSAGE && (data[1] & 0x1F) <= 16)
+	{
+		uint8_t header_size = (data[0] & 0x10) ? 4 : 3;
+		if (size >= (size_t)(header_size + ((data[2] & ASK_TDMA_SLOT_MAP_FLAG) ? ASK_TDMA_SLOT_MAP_SIZE(data[1] & 0x1F) : 0)))
+			return header_size;
+	}
+	return 0;
+}
+
 static void discard_all_messages(ask_receiver_t* receiver)
 {
 	// discards all messages from the receiver
@@ -63,6 +188,37 @@ ask_tdma_client_t::ask_tdma_client_t()
 	_data_slot_available = false;
 	for (uint8_t i = 0; i != 16; ++i)
 		_data_slot_lengths[i] = 0;
+	_join_slot_count = 0;
+	_join_identity = 0;
+	_data_slot_lengths_valid = false;
+	_frame_time = 0;
+	_data_slot_time = 0;
+	_message_id = 0;
+	_data_packet_size = ASK_TDMA_DEFAULT_DATA_PACKET_SIZE;
+	_session_active = false;
+	_session_idle_timeout = 0;
+	_session_keepalive_frames = 0;
+	_listening = false;
+	_synchronization_cached = false;
+	_low_power = false;
+	_reliable_transfer_active = false;
+	_reliable_transfer_receiving = false;
+	_reliable_transfer_acknowledged = false;
+	_reliable_transfer_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+	_reliable_transfer_chunk_size = 0;
+	_reliable_transfer_chunk_count = 0;
+	_reliable_transfer_base = 0;
+	_reliable_transfer_bitmap = 0;
+	_reliable_transfer_buffer = 0;
+	_reliable_transfer_buffer_size = 0;
+	_reliable_transfer_size = 0;
+	_reliable_transfer_error = 0;
+	_message_callback = 0;
+	_message_callback_context = 0;
+	for (int i = 0; i != ASK_TDMA_REASSEMBLY_TRANSFER_COUNT; ++i)
+		_transfers[i].state = ASK_TDMA_TRANSFER_STATE_FREE;
+	_transfer_age = 0;
+	reset_clock_estimate();
 	_bit_rate = 0;
 	_us_per_bit = 0;
 	_rx_pin = NC;
@@ -80,6 +236,37 @@ ask_tdma_client_t::ask_tdma_client_t(PinName rx_pin, PinName tx_pin, int bit_rat
 	_data_slot_available = false;
 	for (uint8_t i = 0; i != 16; ++i)
 		_data_slot_lengths[i] = 0;
+	_join_slot_count = 0;
+	_join_identity = 0;
+	_data_slot_lengths_valid = false;
+	_frame_time = 0;
+	_data_slot_time = 0;
+	_message_id = 0;
+	_data_packet_size = ASK_TDMA_DEFAULT_DATA_PACKET_SIZE;
+	_session_active = false;
+	_session_idle_timeout = 0;
+	_session_keepalive_frames = 0;
+	_listening = false;
+	_synchronization_cached = false;
+	_low_power = false;
+	_reliable_transfer_active = false;
+	_reliable_transfer_receiving = false;
+	_reliable_transfer_acknowledged = false;
+	_reliable_transfer_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+	_reliable_transfer_chunk_size = 0;
+	_reliable_transfer_chunk_count = 0;
+	_reliable_transfer_base = 0;
+	_reliable_transfer_bitmap = 0;
+	_reliable_transfer_buffer = 0;
+	_reliable_transfer_buffer_size = 0;
+	_reliable_transfer_size = 0;
+	_reliable_transfer_error = 0;
+	_message_callback = 0;
+	_message_callback_context = 0;
+	for (int i = 0; i != ASK_TDMA_REASSEMBLY_TRANSFER_COUNT; ++i)
+		_transfers[i].state = ASK_TDMA_TRANSFER_STATE_FREE;
+	_transfer_age = 0;
+	reset_clock_estimate();
 	_bit_rate = 0;
 	_us_per_bit = 0;
 	_rx_pin = NC;
@@ -91,7 +278,9 @@ ask_tdma_client_t::ask_tdma_client_t(PinName rx_pin, PinName tx_pin, int bit_rat
 
 ask_tdma_client_t::~ask_tdma_client_t()
 {
-	// free reserved address on destruction
+	// end session and free reserved address on destruction
+	end_session();
+	end_listening();
 	if (_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS && !join(false))
 		leave(false);
 }
@@ -101,7 +290,9 @@ int ask_tdma_client_t::init(PinName rx_pin, PinName tx_pin, int bit_rate)
 	if (rx_pin == NC || tx_pin == NC || !_receiver.is_valid_frequency(bit_rate) || !_transmitter.is_valid_frequency(bit_rate))
 		return ASK_TDMA_ERROR_INVALID_PARAMETER;
 
-	// when reinitializing, free reserved address
+	// when reinitializing, end session and free reserved address
+	end_session();
+	end_listening();
 	if (_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS && !join(false))
 		leave(false);
 
@@ -114,6 +305,14 @@ int ask_tdma_client_t::init(PinName rx_pin, PinName tx_pin, int bit_rate)
 	_data_slot_available = false;
 	for (uint8_t i = 0; i != 16; ++i)
 		_data_slot_lengths[i] = 0;
+	_join_slot_count = 0;
+	_join_identity = 0;
+	_data_slot_lengths_valid = false;
+	_data_packet_size = ASK_TDMA_DEFAULT_DATA_PACKET_SIZE;
+	_synchronization_cached = false;
+	for (int i = 0; i != ASK_TDMA_REASSEMBLY_TRANSFER_COUNT; ++i)
+		_transfers[i].state = ASK_TDMA_TRANSFER_STATE_FREE;
+	reset_clock_estimate();
 
 	_bit_rate = bit_rate;
 	_us_per_bit = 1000000 / _bit_rate;
@@ -131,13 +330,22 @@ int ask_tdma_client_t::get_base_station_address(uint8_t* address)
 		return 0;
 	}
 
-	// initialize receiver for listenin for base station
-	if (!_receiver.init(_bit_rate, _rx_pin, _reserved_address))
+	// initialize receiver for listenin for base station, listening client may have the address in packets that are not processed yet
+	if (_listening)
+	{
+		listen();
+		if (_base_station_address != ASK_RECEIVER_BROADCAST_ADDRESS)
+		{
+			*address = _base_station_address;
+			return 0;
+		}
+	}
+	else if (!_receiver.init(_bit_rate, _rx_pin, _reserved_address))
 		return ASK_TDMA_ERROR_RECEIVER_ERROR;
 
 	// wait for frame synchronization packet
 	int error = frame_synchronization(false, _reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
-	_receiver.init(0, NC);
+	shutdown_receiver();
 	if (error)
 		return error;
 
@@ -174,176 +382,323 @@ int ask_tdma_client_t::get_address(uint8_t* address)
 
 int ask_tdma_client_t::recv(int timeout, size_t message_buffer_size, void* message_buffer, uint8_t* rx_address, uint8_t* tx_address, size_t* message_received)
 {
-	// initialize receiver for receiving a transfer
-	if (!_receiver.init(_bit_rate, _rx_pin, _reserved_address))
+	// initialize receiver for receiving a transfer, in session the receiver is already running
+	if (!_session_active && !_listening && !_receiver.init(_bit_rate, _rx_pin, _reserved_address))
 		return ASK_TDMA_ERROR_RECEIVER_ERROR;
 
-	uint8_t data_message[16];
-	uint8_t transfer_message[4];
-	size_t transfer_message_size;
-	size_t transfer_size;
+	// unfinished transfers have lost packets if the receiver was not running since last call
+	if (!_session_active && !_listening)
+		for (int i = 0; i != ASK_TDMA_REASSEMBLY_TRANSFER_COUNT; ++i)
+			if (_transfers[i].state == ASK_TDMA_TRANSFER_STATE_RECEIVING)
+				_transfers[i].state = ASK_TDMA_TRANSFER_STATE_FREE;
+
+	uint8_t data_message[ASK_TDMA_MAXIMUM_DATA_PACKET_SIZE];
 	uint8_t receiver;
 	uint8_t sender;
-	size_t transfered = 0;
-	uint8_t transfer_sender = ASK_RECEIVER_BROADCAST_ADDRESS;
-	uint8_t transfer_receiver = ASK_RECEIVER_BROADCAST_ADDRESS;
+
+	// transfer that is larger than reassembly block is received directly to the caller's buffer, only one of them can be received at a time
+	bool message_buffer_used = false;
 
 	if (timeout)
 	{
 		_timer.reset();
 		_timer.start();
-		
-		// wait for transfer packet
-		for (bool waiting_for_transfer = true; waiting_for_transfer;)
+	}
+
+	for (;;)
+	{
+		// deliver transfer that finished first. transfer in reassembly block can not be copied while the caller's buffer is used by other transfer
+		int finished = -1;
+		for (int i = 0; finished == -1 && i != ASK_TDMA_REASSEMBLY_TRANSFER_COUNT; ++i)
+			if ((_transfers[i].state == ASK_TDMA_TRANSFER_STATE_COMPLETE || _transfers[i].state == ASK_TDMA_TRANSFER_STATE_FAILED) && (_transfers[i].direct || !message_buffer_used))
+				finished = i;
+		if (finished != -1)
 		{
-			if (_timer.read_us() >= timeout)
-			{
-				// fail the function if timeout
+			ask_tdma_transfer_t* transfer = _transfers + finished;
+			size_t message_size = (transfer->received < message_buffer_size) ? transfer->received : message_buffer_size;
+			if (!transfer->direct)
+				memcpy(message_buffer, _reassembly_blocks[finished], message_size);
+			transfer->state = ASK_TDMA_TRANSFER_STATE_FREE;
+			if (timeout)
 				_timer.stop();
-				_receiver.init(0, NC);
-				*rx_address = transfer_receiver;
-				*tx_address = transfer_sender;
-				*message_received = transfered;
-				return ASK_TDMA_ERROR_TIMEOUT;
+			drop_direct_transfers();
+			release_receiver();
+			*rx_address = transfer->receiver_address;
+			*tx_address = transfer->sender_address;
+			*message_received = message_size;
+			if (transfer->received != transfer->size)
+				return ASK_TDMA_ERROR_PACKETS_LOST;
+			if (message_size != transfer->size)
+				return ASK_TDMA_ERROR_INSUFFICIENT_BUFFER;
+			if (_session_active)
+				_session_timer.reset();
+			return 0;
+		}
+
+		if (timeout && _timer.read_us() >= timeout)
+		{
+			// fail the function if timeout, the caller gets the data of transfer that was being received to its buffer
+			_timer.stop();
+			*rx_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+			*tx_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+			*message_received = 0;
+			for (int i = 0; i != ASK_TDMA_REASSEMBLY_TRANSFER_COUNT; ++i)
+				if (_transfers[i].state == ASK_TDMA_TRANSFER_STATE_RECEIVING && _transfers[i].direct)
+				{
+					*rx_address = _transfers[i].receiver_address;
+					*tx_address = _transfers[i].sender_address;
+					*message_received = (_transfers[i].received < message_buffer_size) ? _transfers[i].received : message_buffer_size;
+				}
+			drop_direct_transfers();
+			release_receiver();
+			return ASK_TDMA_ERROR_TIMEOUT;
+		}
+
+		size_t message_size = _receiver.recv(&receiver, &sender, data_message, sizeof(data_message));
+		bool express = message_size && (data_message[0] & 0xF) == ASK_TDMA_EXPRESS_MESSAGE;
+		if ((message_size == 4 && (data_message[0] & 0x1F) == ASK_TDMA_TRANSFER_MESSAGE) || express)
+		{
+			// transfer packet received, find entry for the transfer. new transfer from same sender to same receiver replaces the old one
+			// express message is complete transfer, it does not interrupt transfer that is being received
+			size_t transfer_size = express ? message_size - 1 : (size_t)data_message[1] | ((size_t)data_message[2] << 8) | ((size_t)data_message[3] << 16);
+			int entry = -1;
+			for (int i = 0; !express && entry == -1 && i != ASK_TDMA_REASSEMBLY_TRANSFER_COUNT; ++i)
+				if (_transfers[i].state == ASK_TDMA_TRANSFER_STATE_RECEIVING && _transfers[i].sender_address == sender && _transfers[i].receiver_address == receiver)
+					entry = i;
+			if (entry != -1 && _transfers[entry].direct)
+				message_buffer_used = false;
+			for (int i = 0; entry == -1 && i != ASK_TDMA_REASSEMBLY_TRANSFER_COUNT; ++i)
+				if (_transfers[i].state == ASK_TDMA_TRANSFER_STATE_FREE)
+					entry = i;
+
+			// if the table is full, the oldest unfinished transfer is dropped
+			if (entry == -1)
+			{
+				for (int i = 0; i != ASK_TDMA_REASSEMBLY_TRANSFER_COUNT; ++i)
+					if (_transfers[i].state == ASK_TDMA_TRANSFER_STATE_RECEIVING && (entry == -1 || (int32_t)(_transfers[i].age - _transfers[entry].age) < 0))
+						entry = i;
+				if (entry != -1 && _transfers[entry].direct)
+					message_buffer_used = false;
 			}
-			transfer_message_size = _receiver.recv(&transfer_receiver, &transfer_sender, transfer_message, 4);
-			if (transfer_message_size == 4 && (transfer_message[0] & 0xF) == ASK_TDMA_TRANSFER_MESSAGE)
+
+			bool direct = transfer_size > ASK_TDMA_REASSEMBLY_BLOCK_SIZE;
+			if (entry != -1 && (!direct || !message_buffer_used))
 			{
-				// transfer packet received
-				uint32_t tranfer_raw_size = (uint32_t)transfer_message[1] | ((uint32_t)transfer_message[2] << 8) | ((uint32_t)transfer_message[3] << 16);
-				if (tranfer_raw_size > SIZE_MAX)
+				ask_tdma_transfer_t* transfer = _transfers + entry;
+				transfer->state = transfer_size ? ASK_TDMA_TRANSFER_STATE_RECEIVING : ASK_TDMA_TRANSFER_STATE_COMPLETE;
+				transfer->receiver_address = receiver;
+				transfer->sender_address = sender;
+				transfer->direct = direct;
+				transfer->size = transfer_size;
+				transfer->received = 0;
+				transfer->age = _transfer_age++;
+				if (direct)
+					message_buffer_used = true;
+				if (express)
 				{
-					// fail if size of message being transfered is greater than SIZE_MAX
-					_receiver.init(0, NC);
-					*rx_address = transfer_receiver;
-					*tx_address = transfer_sender;
-					*message_received = transfered;
-					return ASK_TDMA_ERROR_TRANSFER_TOO_LARGE;
+					// express message has all data of the transfer
+					size_t buffer_size = direct ? message_buffer_size : ASK_TDMA_REASSEMBLY_BLOCK_SIZE;
+					memcpy(direct ? (uint8_t*)message_buffer : _reassembly_blocks[entry], data_message + 1, (transfer_size < buffer_size) ? transfer_size : buffer_size);
+					transfer->received = transfer_size;
+					transfer->state = ASK_TDMA_TRANSFER_STATE_COMPLETE;
 				}
-				transfer_size = (size_t)tranfer_raw_size;
-				waiting_for_transfer = false;
 			}
 		}
-
-		// begin to read data packets of the transfer
-		bool not_last = true;
-		while (not_last && transfered != transfer_size && _timer.read_us() < timeout)
+		else if (message_size && (data_message[0] & 0xF) == ASK_TDMA_DATA_MESSAGE)
 		{
-			size_t message_size = _receiver.recv(&receiver, &sender, data_message, 16);
-			if (message_size && (data_message[0] & 0xF) == ASK_TDMA_DATA_MESSAGE && receiver == transfer_receiver && sender == transfer_sender)
+			int entry = -1;
+			for (int i = 0; entry == -1 && i != ASK_TDMA_REASSEMBLY_TRANSFER_COUNT; ++i)
+				if (_transfers[i].state == ASK_TDMA_TRANSFER_STATE_RECEIVING && _transfers[i].sender_address == sender && _transfers[i].receiver_address == receiver)
+					entry = i;
+			if (entry != -1)
 			{
-				// data packet received add it's data to message buffer
+				// data packet received add it's data to the transfer, data that does not fit to the caller's buffer is counted but not stored
+				ask_tdma_transfer_t* transfer = _transfers + entry;
 				--message_size;
-				not_last = (data_message[0] & 0x10) != 0;
-				if (message_size > transfer_size - transfered)
-					message_size = transfer_size - transfered;
-				for (uint8_t* i = data_message + 1, *e = i + message_size; i != e; ++i, message_buffer = (void*)((uintptr_t)message_buffer + 1))
-					*(uint8_t*)message_buffer = *i;
-				transfered += message_size;
+				bool not_last = (data_message[0] & 0x10) != 0;
+				if (message_size > transfer->size - transfer->received)
+					message_size = transfer->size - transfer->received;
+				uint8_t* buffer = transfer->direct ? (uint8_t*)message_buffer : _reassembly_blocks[entry];
+				size_t buffer_size = transfer->direct ? message_buffer_size : ASK_TDMA_REASSEMBLY_BLOCK_SIZE;
+				if (transfer->received < buffer_size)
+					memcpy(buffer + transfer->received, data_message + 1, (message_size < buffer_size - transfer->received) ? message_size : buffer_size - transfer->received);
+				transfer->received += message_size;
+				if (transfer->received == transfer->size)
+					transfer->state = ASK_TDMA_TRANSFER_STATE_COMPLETE;
+				else if (!not_last)
+					transfer->state = ASK_TDMA_TRANSFER_STATE_FAILED;
 			}
 		}
-		bool error_timeout = (not_last && transfered != transfer_size) ? _timer.read_us() >= timeout : false;
-		_timer.stop();
-		_receiver.init(0, NC);
-		*rx_address = transfer_receiver;
-		*tx_address = transfer_sender;
-		*message_received = transfered;
-		if (transfered != transfer_size)
-		{
-			if (error_timeout)
-				return ASK_TDMA_ERROR_TIMEOUT;
-			else if (!not_last)
-				return ASK_TDMA_ERROR_PACKETS_LOST;
-			else
-				return ASK_TDMA_ERROR_INSUFFICIENT_BUFFER;
-		}
-		return 0;
 	}
-	else
+}
+
+int ask_tdma_client_t::recv_stream(int timeout, ask_tdma_sink_callback_t sink, void* context, uint8_t* rx_address, uint8_t* tx_address, size_t* message_received)
+{
+	// initialize receiver for receiving a transfer, in session the receiver is already running
+	if (!_session_active && !_listening && !_receiver.init(_bit_rate, _rx_pin, _reserved_address))
+		return ASK_TDMA_ERROR_RECEIVER_ERROR;
+
+	uint8_t data_message[ASK_TDMA_MAXIMUM_DATA_PACKET_SIZE];
+	size_t message_size;
+	uint8_t receiver;
+	uint8_t sender;
+	size_t transfer_size = 0;
+	size_t transfered = 0;
+	uint8_t transfer_sender = ASK_RECEIVER_BROADCAST_ADDRESS;
+	uint8_t transfer_receiver = ASK_RECEIVER_BROADCAST_ADDRESS;
+	bool waiting_for_transfer = true;
+	bool not_last = true;
+	bool aborted = false;
+
+	if (timeout)
+	{
+		_timer.reset();
+		_timer.start();
+	}
+
+	// the receiver keeps receiving packets to its buffer while the sink processes the data
+	while ((waiting_for_transfer || (not_last && transfered != transfer_size)) && !aborted && (!timeout || _timer.read_us() < timeout))
 	{
-		// wait for transfer packet
-		for (bool waiting_for_transfer = true; waiting_for_transfer;)
+		message_size = _receiver.recv(&receiver, &sender, data_message, sizeof(data_message));
+		if (waiting_for_transfer)
 		{
-			transfer_message_size = _receiver.recv(&transfer_receiver, &transfer_sender, transfer_message, 4);
-			if (transfer_message_size == 4 && (transfer_message[0] & 0xF) == ASK_TDMA_TRANSFER_MESSAGE)
+			if (message_size == 4 && (data_message[0] & 0x1F) == ASK_TDMA_TRANSFER_MESSAGE)
 			{
 				// transfer packet received
-				uint32_t tranfer_raw_size = (uint32_t)transfer_message[1] | ((uint32_t)transfer_message[2] << 8) | ((uint32_t)transfer_message[3] << 16);
-				if (tranfer_raw_size > SIZE_MAX)
-				{
-					// fail if size of message being transfered is greater than SIZE_MAX
-					_receiver.init(0, NC);
-					*rx_address = transfer_receiver;
-					*tx_address = transfer_sender;
-					*message_received = transfered;
-					return ASK_TDMA_ERROR_TRANSFER_TOO_LARGE;
-				}
-				transfer_size = (size_t)tranfer_raw_size;
+				transfer_size = (size_t)data_message[1] | ((size_t)data_message[2] << 8) | ((size_t)data_message[3] << 16);
+				transfer_sender = sender;
+				transfer_receiver = receiver;
 				waiting_for_transfer = false;
 			}
-		}
-
-		// begin to read data packets of the transfer
-		bool not_last = true;
-		while (not_last && transfered != transfer_size)
-		{
-			size_t message_size = _receiver.recv(&receiver, &sender, data_message, 16);
-			if (message_size && (data_message[0] & 0xF) == ASK_TDMA_DATA_MESSAGE && receiver == transfer_receiver && sender == transfer_sender)
+			else if (message_size && (data_message[0] & 0xF) == ASK_TDMA_EXPRESS_MESSAGE)
 			{
-				// data packet received add it's data to message buffer
-				--message_size;
-				not_last = (data_message[0] & 0x10) != 0;
-				if (message_size > transfer_size - transfered)
-					message_size = transfer_size - transfered;
-				for (uint8_t* i = data_message + 1, *e = i + message_size; i != e; ++i, message_buffer = (void*)((uintptr_t)message_buffer + 1))
-					*(uint8_t*)message_buffer = *i;
-				transfered += message_size;
+				// express message is passed to the sink at once
+				transfer_size = message_size - 1;
+				transfer_sender = sender;
+				transfer_receiver = receiver;
+				waiting_for_transfer = false;
+				if (transfer_size && !sink(context, 0, data_message + 1, transfer_size))
+					aborted = true;
+				else
+					transfered = transfer_size;
 			}
 		}
-		_receiver.init(0, NC);
-		*rx_address = transfer_receiver;
-		*tx_address = transfer_sender;
-		*message_received = transfered;
-		if (transfered != transfer_size)
+		else if (message_size && (data_message[0] & 0xF) == ASK_TDMA_DATA_MESSAGE && receiver == transfer_receiver && sender == transfer_sender)
 		{
-			if (!not_last)
-				return ASK_TDMA_ERROR_PACKETS_LOST;
+			// data packet received pass it's data to the sink
+			--message_size;
+			not_last = (data_message[0] & 0x10) != 0;
+			if (message_size > transfer_size - transfered)
+				message_size = transfer_size - transfered;
+			if (message_size && !sink(context, transfered, data_message + 1, message_size))
+				aborted = true;
 			else
-				return ASK_TDMA_ERROR_INSUFFICIENT_BUFFER;
+				transfered += message_size;
 		}
-		return 0;
 	}
+	bool error_timeout = timeout && (waiting_for_transfer || (not_last && transfered != transfer_size)) && _timer.read_us() >= timeout;
+	if (timeout)
+		_timer.stop();
+	release_receiver();
+	*rx_address = transfer_receiver;
+	*tx_address = transfer_sender;
+	*message_received = transfered;
+	if (aborted)
+		return ASK_TDMA_ERROR_STREAM_ABORTED;
+	if (error_timeout)
+		return ASK_TDMA_ERROR_TIMEOUT;
+	if (transfered != transfer_size)
+		return ASK_TDMA_ERROR_PACKETS_LOST;
+	if (_session_active)
+		_session_timer.reset();
+	return 0;
+}
+
+void ask_tdma_client_t::drop_direct_transfers()
+{
+	// transfers received to the caller's buffer can not continue after recv returns
+	for (int i = 0; i != ASK_TDMA_REASSEMBLY_TRANSFER_COUNT; ++i)
+		if (_transfers[i].state != ASK_TDMA_TRANSFER_STATE_FREE && _transfers[i].direct)
+			_transfers[i].state = ASK_TDMA_TRANSFER_STATE_FREE;
 }
 
 int ask_tdma_client_t::send(uint8_t rx_address, size_t message_size, const void* message_data, size_t* message_send)
 {
-	// join to network for transfering a massage
-	int error = join(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+	return send_transfer(rx_address, message_size, message_data, 0, 0, message_send);
+}
+
+int ask_tdma_client_t::send_stream(uint8_t rx_address, size_t message_size, ask_tdma_source_callback_t source, void* context, size_t* message_send)
+{
+	return send_transfer(rx_address, message_size, 0, source, context, message_send);
+}
+
+int ask_tdma_client_t::send_transfer(uint8_t rx_address, size_t message_size, const void* message_data, ask_tdma_source_callback_t source, void* context, size_t* message_send)
+{
+	// size of the transfer is send in 3 bytes
+	if (message_size > 0xFFFFFF)
+	{
+		*message_send = 0;
+		return ASK_TDMA_ERROR_TRANSFER_TOO_LARGE;
+	}
+
+	// join to network for transfering a massage, if not already connected
+	int error = connect();
 	if (error)
+	{
+		*message_send = 0;
 		return error;
+	}
 
-	uint8_t data_message[16];
+	uint8_t data_message_header;
+	ask_transmitter_buffer_t data_message[2] = { { &data_message_header, 1 }, { 0, 0 } };
 
-	uint8_t data_slot_available = wait_for_data_slot();
+	// streamed message is read one packet at a time to this buffer
+	uint8_t source_buffer[ASK_TDMA_MAXIMUM_DATA_PACKET_SIZE];
 
-	if (data_slot_available)
+	// every data packet is the size of the network's data packets, so the packets fill the slot time reserved for them
+	size_t maximum_packet_message_size = (size_t)_data_packet_size - 1;
+
+	uint8_t data_slot_available = get_data_slot();
+
+	// packets are scheduled to be send one after another from the beginning of the data slot
+	uint32_t packet_time = _data_slot_time;
+
+	// message that fits to single packet is send as express message without transfer packet
+	bool express = message_size <= maximum_packet_message_size;
+
+	if (data_slot_available && express)
+	{
+		if (source && message_size && source(context, 0, source_buffer, message_size) != message_size)
+		{
+			_session_active = false;
+			leave(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+			*message_send = 0;
+			return ASK_TDMA_ERROR_STREAM_ABORTED;
+		}
+		data_message_header = (uint8_t)(ASK_TDMA_EXPRESS_MESSAGE | (_frame_number << 5));
+		data_message[1].data = source ? (const void*)source_buffer : message_data;
+		data_message[1].length = message_size;
+		_transmitter.sendv_at(packet_time, rx_address, get_message_id(), 0, data_message, 2);
+	}
+	else if (data_slot_available)
 	{
 		// if joining to network succeeds, data slot should be available
 		// send transfer packet to begin the transfer
 		uint8_t transfer_message[4] = { (uint8_t)(ASK_TDMA_TRANSFER_MESSAGE | (_frame_number << 5)), (uint8_t)message_size, (uint8_t)(message_size >> 8), (uint8_t)(message_size >> 16) };
-		_transmitter.send(rx_address, transfer_message, 4);
+		_transmitter.send_at(packet_time, rx_address, get_message_id(), 0, transfer_message, 4);
 		--data_slot_available;
-		wait_us(330 * _us_per_bit);
+		packet_time += base_time_to_local_time(ASK_TDMA_DATA_PACKET_LENGTH(_data_packet_size));
 	}
 	else
 	{
 		// this code should not be possible to reach if thins are working correctly
+		_session_active = false;
 		leave(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
 		*message_send = 0;
 		return ASK_TDMA_ERROR_MALFUNCTIONING_NETWORK;
 	}
 
-	size_t message_remaining = message_size;
+	size_t message_remaining = express ? 0 : message_size;
 
 	// loop until the message is sent
 	while (message_remaining)
@@ -351,13 +706,31 @@ int ask_tdma_client_t::send(uint8_t rx_address, size_t message_size, const void*
 		// send data packets of the current frame
 		for (uint8_t i = 0; message_remaining && i != data_slot_available; ++i)
 		{
-			size_t packet_message_size = (message_remaining < 16) ? message_remaining : 15;
+			size_t packet_message_size = (message_remaining < maximum_packet_message_size) ? message_remaining : maximum_packet_message_size;
+
+			if (source)
+			{
+				// pull next part of streamed message from the source
+				if (source(context, message_size - message_remaining, source_buffer, packet_message_size) != packet_message_size)
+				{
+					_session_active = false;
+					leave(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+					*message_send = message_size - message_remaining;
+					return ASK_TDMA_ERROR_STREAM_ABORTED;
+				}
+				data_message[1].data = source_buffer;
+			}
+			else
+				data_message[1].data = message_data;
 			message_remaining -= packet_message_size;
-			data_message[0] = (uint8_t)(ASK_TDMA_DATA_MESSAGE | ((message_remaining ? 1 : 0) << 4) | (_frame_number << 5));
-			for (uint8_t* i = data_message + 1, *e = i + packet_message_size; i != e; ++i, message_data = (const void*)((uintptr_t)message_data + 1))
-				*i = *(const uint8_t*)message_data;
-			_transmitter.send(rx_address, data_message, 1 + packet_message_size);
-			wait_us(330 * _us_per_bit);
+
+			// data packet header is followed by the next part of the message, that is send directly from caller's buffer
+			data_message_header = (uint8_t)(ASK_TDMA_DATA_MESSAGE | ((message_remaining ? 1 : 0) << 4) | (_frame_number << 5));
+			data_message[1].length = packet_message_size;
+			_transmitter.sendv_at(packet_time, rx_address, get_message_id(), 0, data_message, 2);
+			if (!source)
+				message_data = (const void*)((uintptr_t)message_data + packet_message_size);
+			packet_time += base_time_to_local_time(ASK_TDMA_DATA_PACKET_LENGTH(_data_packet_size));
 		}
 
 		// if more data packet to send wait for next frame
@@ -366,14 +739,17 @@ int ask_tdma_client_t::send(uint8_t rx_address, size_t message_size, const void*
 			error = frame_synchronization(false, _reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
 			if (error)
 			{
+				_session_active = false;
 				leave(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
 				*message_send = message_size - message_remaining;
 				return error;
 			}
-			data_slot_available = wait_for_data_slot();
+			data_slot_available = get_data_slot();
+			packet_time = _data_slot_time;
 			if (!data_slot_available)
 			{
 				// this code should not be possible to reach if thins are working correctly
+				_session_active = false;
 				leave(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
 				*message_send = message_size - message_remaining;
 				return ASK_TDMA_ERROR_MALFUNCTIONING_NETWORK;
@@ -382,124 +758,821 @@ int ask_tdma_client_t::send(uint8_t rx_address, size_t message_size, const void*
 	}
 
 	// leave network when, transfer finished
-	leave(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+	disconnect();
 	*message_send = message_size;
 	return 0;
 }
 
+int ask_tdma_client_t::send_reliable(uint8_t rx_address, size_t message_size, const void* message_data, size_t* message_send, int timeout)
+{
+	*message_send = 0;
+
+	// reliable transfer needs acknowledgements from single receiver
+	if (rx_address == ASK_RECEIVER_BROADCAST_ADDRESS)
+		return ASK_TDMA_ERROR_INVALID_ADDRESS;
+	if (timeout < 0)
+		return ASK_TDMA_ERROR_INVALID_PARAMETER;
+	if (message_size > 0xFFFFFF)
+		return ASK_TDMA_ERROR_TRANSFER_TOO_LARGE;
+
+	int error = connect();
+	if (error)
+		return error;
+
+	// chunks are send in sequenced data packets, that have 2 byte sequence number after the header
+	uint8_t chunk_size = _data_packet_size - 3;
+	size_t chunk_count = (message_size + (size_t)chunk_size - 1) / (size_t)chunk_size;
+	if (chunk_count > 0xFFFF)
+	{
+		disconnect();
+		return ASK_TDMA_ERROR_TRANSFER_TOO_LARGE;
+	}
+
+	uint8_t data_message_header[3];
+	ask_transmitter_buffer_t data_message[2] = { { data_message_header, 3 }, { 0, 0 } };
+	uint8_t transfer_message[5] = { 0, (uint8_t)message_size, (uint8_t)(message_size >> 8), (uint8_t)(message_size >> 16), chunk_size };
+
+	// acknowledgements received while waiting for frame synchronization update the window
+	_reliable_transfer_active = true;
+	_reliable_transfer_receiving = false;
+	_reliable_transfer_address = rx_address;
+	_reliable_transfer_chunk_count = (uint16_t)chunk_count;
+	_reliable_transfer_base = 0;
+	_reliable_transfer_bitmap = 0;
+	_reliable_transfer_acknowledged = false;
+
+	Timer transfer_timer;
+	transfer_timer.start();
+
+	// chunks of the window that are not acknowledged are send in turns, so lost chunks are repeated until they are acknowledged
+	uint16_t next_chunk = 0;
+	while (_reliable_transfer_base != _reliable_transfer_chunk_count || !_reliable_transfer_acknowledged)
+	{
+		if (timeout && transfer_timer.read_us() >= timeout)
+		{
+			error = ASK_TDMA_ERROR_TIMEOUT;
+			break;
+		}
+
+		uint8_t data_slot_available = get_data_slot();
+		uint32_t packet_time = _data_slot_time;
+		if (data_slot_available && !_reliable_transfer_acknowledged)
+		{
+			// transfer packet is repeated until the receiver acknowledges the transfer
+			transfer_message[0] = (uint8_t)(ASK_TDMA_TRANSFER_MESSAGE | ASK_TDMA_RELIABLE_TRANSFER_FLAG | (_frame_number << 5));
+			_transmitter.send_at(packet_time, rx_address, get_message_id(), 0, transfer_message, 5);
+			--data_slot_available;
+			packet_time += base_time_to_local_time(ASK_TDMA_DATA_PACKET_LENGTH(_data_packet_size));
+		}
+
+		uint16_t window_end = (_reliable_transfer_chunk_count - _reliable_transfer_base > ASK_TDMA_ACKNOWLEDGEMENT_WINDOW_SIZE) ? _reliable_transfer_base + ASK_TDMA_ACKNOWLEDGEMENT_WINDOW_SIZE : _reliable_transfer_chunk_count;
+		for (uint8_t i = 0, s = 0; i != data_slot_available && s != ASK_TDMA_ACKNOWLEDGEMENT_WINDOW_SIZE && _reliable_transfer_base != window_end; ++s)
+		{
+			if (next_chunk < _reliable_transfer_base || next_chunk >= window_end)
+				next_chunk = _reliable_transfer_base;
+			uint16_t chunk = next_chunk++;
+			if (_reliable_transfer_bitmap & ((uint32_t)1 << (chunk - _reliable_transfer_base)))
+				continue;
+
+			size_t chunk_offset = (size_t)chunk * (size_t)chunk_size;
+			data_message_header[0] = (uint8_t)(ASK_TDMA_SEQUENCED_DATA_MESSAGE | (_frame_number << 5));
+			data_message_header[1] = (uint8_t)chunk;
+			data_message_header[2] = (uint8_t)(chunk >> 8);
+			data_message[1].data = (const void*)((uintptr_t)message_data + chunk_offset);
+			data_message[1].length = (message_size - chunk_offset < (size_t)chunk_size) ? message_size - chunk_offset : (size_t)chunk_size;
+			_transmitter.sendv_at(packet_time, rx_address, get_message_id(), 0, data_message, 2);
+			packet_time += base_time_to_local_time(ASK_TDMA_DATA_PACKET_LENGTH(_data_packet_size));
+			++i;
+		}
+
+		// wait for next frame, acknowledgements send in this frame are processed while waiting
+		error = frame_synchronization(false, _reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+		if (error)
+			break;
+		if (!_data_slot_available)
+		{
+			error = ASK_TDMA_ERROR_MALFUNCTIONING_NETWORK;
+			break;
+		}
+	}
+	transfer_timer.stop();
+
+	_reliable_transfer_active = false;
+	*message_send = ((size_t)_reliable_transfer_base * (size_t)chunk_size < message_size) ? (size_t)_reliable_transfer_base * (size_t)chunk_size : message_size;
+	if (error)
+	{
+		_session_active = false;
+		leave(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+		return error;
+	}
+	disconnect();
+	return 0;
+}
+
+int ask_tdma_client_t::recv_reliable(int timeout, size_t message_buffer_size, void* message_buffer, uint8_t* rx_address, uint8_t* tx_address, size_t* message_received)
+{
+	*rx_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+	*tx_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+	*message_received = 0;
+	if (timeout < 0)
+		return ASK_TDMA_ERROR_INVALID_PARAMETER;
+
+	// the receiver needs to be connected to the network to send acknowledgements in its data slot
+	int error = connect();
+	if (error)
+		return error;
+
+	// data of the chunks is written directly to its place in the caller's buffer, the acknowledgement window tracks received chunks
+	_reliable_transfer_active = true;
+	_reliable_transfer_receiving = true;
+	_reliable_transfer_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+	_reliable_transfer_chunk_count = 0;
+	_reliable_transfer_base = 0;
+	_reliable_transfer_bitmap = 0;
+	_reliable_transfer_acknowledged = false;
+	_reliable_transfer_buffer = message_buffer;
+	_reliable_transfer_buffer_size = message_buffer_size;
+	_reliable_transfer_size = 0;
+	_reliable_transfer_error = 0;
+
+	Timer transfer_timer;
+	transfer_timer.start();
+
+	int final_acknowledgements = 0;
+	while (final_acknowledgements != ASK_TDMA_FINAL_ACKNOWLEDGEMENT_COUNT)
+	{
+		if (timeout && transfer_timer.read_us() >= timeout)
+		{
+			error = ASK_TDMA_ERROR_TIMEOUT;
+			break;
+		}
+
+		// chunks of the transfer are received while waiting for frame synchronization
+		error = frame_synchronization(false, _reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+		if (!error && !_data_slot_available)
+			error = ASK_TDMA_ERROR_MALFUNCTIONING_NETWORK;
+		if (!error)
+			error = _reliable_transfer_error;
+		if (error)
+			break;
+
+		if (_reliable_transfer_acknowledged && get_data_slot())
+		{
+			// send acknowledgement of the window every frame, the sender repeats only chunks that are missing from it
+			uint8_t acknowledgement_message[7] = {
+				(uint8_t)(ASK_TDMA_ACKNOWLEDGEMENT_MESSAGE | (_frame_number << 5)),
+				(uint8_t)_reliable_transfer_base, (uint8_t)(_reliable_transfer_base >> 8),
+				(uint8_t)_reliable_transfer_bitmap, (uint8_t)(_reliable_transfer_bitmap >> 8), (uint8_t)(_reliable_transfer_bitmap >> 16), (uint8_t)(_reliable_transfer_bitmap >> 24) };
+			_transmitter.send_at(_data_slot_time, _reliable_transfer_address, get_message_id(), 0, acknowledgement_message, 7);
+			if (_reliable_transfer_base == _reliable_transfer_chunk_count)
+				++final_acknowledgements;
+		}
+	}
+	transfer_timer.stop();
+
+	_reliable_transfer_active = false;
+	*rx_address = _receiver.rx_address;
+	*tx_address = _reliable_transfer_address;
+	if (_reliable_transfer_acknowledged)
+		*message_received = (_reliable_transfer_base == _reliable_transfer_chunk_count) ? _reliable_transfer_size : (size_t)_reliable_transfer_base * (size_t)_reliable_transfer_chunk_size;
+	if (error)
+	{
+		_session_active = false;
+		leave(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+		return error;
+	}
+	disconnect();
+	return 0;
+}
+
+int ask_tdma_client_t::connect()
+{
+	if (_session_active && _temporal_address != ASK_RECEIVER_BROADCAST_ADDRESS)
+	{
+		// in session the client is already connected to the network and it only waits for the next frame
+		process_pending_messages();
+		int error = frame_synchronization(false, _reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+		if (error)
+		{
+			_session_active = false;
+			shutdown_receiver();
+			_transmitter.init(0, NC);
+			return error;
+		}
+		if (_temporal_address != ASK_RECEIVER_BROADCAST_ADDRESS)
+			return 0;
+	}
+
+	int error = join(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+	if (error)
+		_session_active = false;
+	return error;
+}
+
+void ask_tdma_client_t::disconnect()
+{
+	// in session the client stays connected and sends keepalive on the next frame
+	if (_session_active)
+	{
+		_session_keepalive_frames = 0;
+		_session_timer.reset();
+	}
+	else
+		leave(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+}
+
+void ask_tdma_client_t::process_pending_messages()
+{
+	// process or discard messages that are already received
+	uint8_t data[ASK_TDMA_MAXIMUM_DATA_PACKET_SIZE];
+	uint8_t receiver_address;
+	uint8_t sender_address;
+	ask_receiver_status_t status;
+	_receiver.status(&status);
+	for (int i = 0; i != status.packets_available; ++i)
+	{
+		size_t size = _receiver.recv(&receiver_address, &sender_address, data, sizeof(data));
+		if (size && !get_synchronization_header_size(data, size))
+			process_message(receiver_address, sender_address, data, size);
+	}
+}
+
+void ask_tdma_client_t::process_message(uint8_t receiver_address, uint8_t sender_address, const uint8_t* message, size_t message_size)
+{
+	if (_reliable_transfer_active)
+		process_reliable_transfer_message(receiver_address, sender_address, message, message_size);
+	else if (_message_callback)
+		_message_callback(_message_callback_context, receiver_address, sender_address, message, message_size);
+}
+
+void ask_tdma_client_t::process_reliable_transfer_message(uint8_t receiver_address, uint8_t sender_address, const uint8_t* message, size_t message_size)
+{
+	if (receiver_address != _receiver.rx_address || receiver_address == ASK_RECEIVER_BROADCAST_ADDRESS || !message_size)
+		return;
+	if (!_reliable_transfer_receiving)
+	{
+		// sender processes acknowledgements from the receiver, the window only moves forward
+		if (sender_address == _reliable_transfer_address && message_size == 7 && (message[0] & 0xF) == ASK_TDMA_ACKNOWLEDGEMENT_MESSAGE)
+		{
+			uint16_t base = (uint16_t)message[1] | ((uint16_t)message[2] << 8);
+			if (base >= _reliable_transfer_base && base <= _reliable_transfer_chunk_count)
+			{
+				_reliable_transfer_base = base;
+				_reliable_transfer_bitmap = (uint32_t)message[3] | ((uint32_t)message[4] << 8) | ((uint32_t)message[5] << 16) | ((uint32_t)message[6] << 24);
+				_reliable_transfer_acknowledged = true;
+			}
+		}
+		return;
+	}
+
+	if (!_reliable_transfer_acknowledged)
+	{
+		// receiver waits for transfer packet of reliable transfer
+		if (message_size == 5 && (message[0] & 0x1F) == (ASK_TDMA_TRANSFER_MESSAGE | ASK_TDMA_RELIABLE_TRANSFER_FLAG) && message[4])
+		{
+			// transfer of more chunks than the 16 bit sequence numbers can address is not valid
+			size_t transfer_size = (size_t)message[1] | ((size_t)message[2] << 8) | ((size_t)message[3] << 16);
+			size_t chunk_count = (transfer_size + (size_t)message[4] - 1) / (size_t)message[4];
+			if (chunk_count > 0xFFFF)
+				return;
+			_reliable_transfer_address = sender_address;
+			_reliable_transfer_size = transfer_size;
+			_reliable_transfer_chunk_size = message[4];
+			_reliable_transfer_chunk_count = (uint16_t)chunk_count;
+			_reliable_transfer_acknowledged = true;
+			if (transfer_size > _reliable_transfer_buffer_size)
+				_reliable_transfer_error = ASK_TDMA_ERROR_INSUFFICIENT_BUFFER;
+		}
+		return;
+	}
+
+	// no chunks are accepted after the transfer has failed
+	if (_reliable_transfer_error || sender_address != _reliable_transfer_address || message_size < 3 || (message[0] & 0xF) != ASK_TDMA_SEQUENCED_DATA_MESSAGE)
+		return;
+
+	// chunks outside of the window are already received or the sender is ahead of acknowledgements
+	uint16_t chunk = (uint16_t)message[1] | ((uint16_t)message[2] << 8);
+	if (chunk < _reliable_transfer_base || chunk >= _reliable_transfer_chunk_count || chunk - _reliable_transfer_base >= ASK_TDMA_ACKNOWLEDGEMENT_WINDOW_SIZE)
+		return;
+	uint32_t chunk_bit = (uint32_t)1 << (chunk - _reliable_transfer_base);
+	if (!(_reliable_transfer_bitmap & chunk_bit))
+	{
+		size_t chunk_offset = (size_t)chunk * (size_t)_reliable_transfer_chunk_size;
+		if (chunk_offset >= _reliable_transfer_size || chunk_offset >= _reliable_transfer_buffer_size)
+			return;
+		size_t chunk_size = message_size - 3;
+		if (chunk_size > _reliable_transfer_size - chunk_offset)
+			chunk_size = _reliable_transfer_size - chunk_offset;
+		if (chunk_size > _reliable_transfer_buffer_size - chunk_offset)
+			chunk_size = _reliable_transfer_buffer_size - chunk_offset;
+		if (chunk_size > (size_t)_reliable_transfer_chunk_size)
+			chunk_size = (size_t)_reliable_transfer_chunk_size;
+		memcpy((void*)((uintptr_t)_reliable_transfer_buffer + chunk_offset), message + 3, chunk_size);
+		_reliable_transfer_bitmap |= chunk_bit;
+	}
+
+	// move the window over received chunks from the beginning of it
+	while (_reliable_transfer_base != _reliable_transfer_chunk_count && (_reliable_transfer_bitmap & 1))
+	{
+		_reliable_transfer_bitmap >>= 1;
+		++_reliable_transfer_base;
+	}
+}
+
+int ask_tdma_client_t::begin_session(int idle_timeout)
+{
+	if (idle_timeout < 0)
+		return ASK_TDMA_ERROR_INVALID_PARAMETER;
+
+	// join to network once for the whole session
+	if (!_session_active)
+	{
+		int error = join(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+		if (error)
+			return error;
+		_session_active = true;
+	}
+
+	_session_idle_timeout = idle_timeout;
+	_session_keepalive_frames = 0;
+	_session_timer.reset();
+	_session_timer.start();
+	return 0;
+}
+
+int ask_tdma_client_t::maintain_session()
+{
+	if (!_session_active)
+		return ASK_TDMA_ERROR_NO_NETWORK;
+
+	// end the session if it has been idle too long
+	if (_session_idle_timeout && _session_timer.read_us() >= _session_idle_timeout)
+	{
+		end_session();
+		return ASK_TDMA_ERROR_TIMEOUT;
+	}
+
+	// join back to the network if the client has been disconnected
+	if (_temporal_address == ASK_RECEIVER_BROADCAST_ADDRESS)
+	{
+		int error = join(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+		if (error)
+			_session_active = false;
+		_session_keepalive_frames = 0;
+		return error;
+	}
+
+	// wait for next frame
+	process_pending_messages();
+	int error = frame_synchronization(false, _reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+	if (error)
+	{
+		_session_active = false;
+		shutdown_receiver();
+		_transmitter.init(0, NC);
+		return error;
+	}
+
+	// send keepalive message in the data slot, so the base station does not remove idle client from the network
+	if (!_session_keepalive_frames && get_data_slot())
+	{
+		uint8_t keepalive_message = ASK_TDMA_KEEPALIVE_MESSAGE | (_frame_number << 5);
+		_transmitter.send_at(_data_slot_time, _base_station_address, get_message_id(), 0, &keepalive_message, 1);
+		_session_keepalive_frames = ASK_TDMA_KEEPALIVE_INTERVAL;
+	}
+	else if (_session_keepalive_frames)
+		--_session_keepalive_frames;
+	return 0;
+}
+
+int ask_tdma_client_t::end_session()
+{
+	if (!_session_active)
+		return 0;
+
+	_session_active = false;
+	_session_timer.stop();
+
+	// leave the network if the client is still connected
+	if (_temporal_address != ASK_RECEIVER_BROADCAST_ADDRESS)
+		return leave(_reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+
+	shutdown_receiver();
+	_transmitter.init(0, NC);
+	return 0;
+}
+
+void ask_tdma_client_t::release_receiver()
+{
+	// in session the receiver keeps running between transfers
+	if (!_session_active)
+		shutdown_receiver();
+}
+
+void ask_tdma_client_t::shutdown_receiver()
+{
+	// listening client keeps the receiver running, only the address of the receiver is restored
+	if (_listening)
+		_receiver.rx_address = _reserved_address;
+	else
+		_receiver.init(0, NC);
+}
+
+int ask_tdma_client_t::begin_listening()
+{
+	if (_listening)
+		return 0;
+
+	// the receiver keeps running, so packets of the network are buffered between calls to the client
+	if (!_session_active && !_receiver.init(_bit_rate, _rx_pin, _reserved_address))
+		return ASK_TDMA_ERROR_RECEIVER_ERROR;
+	_listening = true;
+	return 0;
+}
+
+int ask_tdma_client_t::listen()
+{
+	if (!_listening)
+		return ASK_TDMA_ERROR_NO_NETWORK;
+
+	// process all packets received since last call, state of the network is updated from every frame synchronization packet
+	uint8_t data[ASK_TDMA_MAXIMUM_DATA_PACKET_SIZE];
+	uint8_t receiver_address;
+	uint8_t sender_address;
+	ask_receiver_status_t status;
+	_receiver.status(&status);
+	for (int i = 0; i != status.packets_available; ++i)
+	{
+		uint8_t size = (uint8_t)_receiver.recv(&receiver_address, &sender_address, data, sizeof(data));
+		if (receiver_address == ASK_RECEIVER_BROADCAST_ADDRESS && get_synchronization_header_size(data, size))
+		{
+			process_synchronization_message(sender_address, data, size, false, _reserved_address != ASK_RECEIVER_BROADCAST_ADDRESS);
+			_synchronization_cached = true;
+		}
+		else if (size)
+			process_message(receiver_address, sender_address, data, (size_t)size);
+	}
+
+	// cached state of the network is forgotten, if frame synchronization packets have not been received for a long time
+	if (_base_station_address != ASK_RECEIVER_BROADCAST_ADDRESS && _temporal_address == ASK_RECEIVER_BROADCAST_ADDRESS &&
+		us_ticker_read() - _frame_time >= (uint32_t)(ASK_TDMA_TIMEOUT_MULTIPLIER * ASK_TDMA_ASSUMED_MAXIMUM_FRAME_LENGTH(_data_packet_size) * _us_per_bit))
+	{
+		_base_station_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+		_synchronization_cached = false;
+	}
+
+	if (_base_station_address == ASK_RECEIVER_BROADCAST_ADDRESS)
+		return ASK_TDMA_ERROR_NO_NETWORK;
+	return 0;
+}
+
+void ask_tdma_client_t::end_listening()
+{
+	if (!_listening)
+		return;
+
+	_listening = false;
+	_synchronization_cached = false;
+	if (!_session_active)
+		_receiver.init(0, NC);
+}
+
 int ask_tdma_client_t::frame_synchronization(bool join, bool reserve_address)
 {
-	uint8_t data[34];
+	uint8_t data[ASK_TDMA_MAXIMUM_DATA_PACKET_SIZE];
 	uint8_t size;
 	uint8_t receiver_address;
 	uint8_t sender_address;
 
+	// frame synchronization packet processed by listen is used, if it is not older than ASK_TDMA_SYNCHRONIZATION_MAXIMUM_AGE
+	if (!join && _synchronization_cached)
+	{
+		_synchronization_cached = false;
+		if (us_ticker_read() - _frame_time < (uint32_t)(ASK_TDMA_SYNCHRONIZATION_MAXIMUM_AGE * _us_per_bit))
+		{
+			process_pending_messages();
+			return 0;
+		}
+	}
+
+	// in low power mode the receiver sleeps until shortly before the next frame synchronization packet
+	if (_low_power)
+		sleep_until_next_frame();
+
 	_timer.reset();
 	_timer.start();
 
 	// wait for frame synchronization packet
-	while (_timer.read_us() < ASK_TDMA_TIMEOUT_MULTIPLIER * ASK_TDMA_ASSUMED_MAXIMUM_FRAME_LENGTH * _us_per_bit)
+	while (_timer.read_us() < ASK_TDMA_TIMEOUT_MULTIPLIER * ASK_TDMA_ASSUMED_MAXIMUM_FRAME_LENGTH(_data_packet_size) * _us_per_bit)
 	{
-		size = (uint8_t)_receiver.recv(&receiver_address, &sender_address, data, 34);
+		size = (uint8_t)_receiver.recv(&receiver_address, &sender_address, data, sizeof(data));
 
-		if (receiver_address == ASK_RECEIVER_BROADCAST_ADDRESS && size > 1 && (data[0] & 0xF) == ASK_TDMA_SYNCHRONIZATION_MESSAGE)
+		// frame synchronization packet that is older than ASK_TDMA_SYNCHRONIZATION_MAXIMUM_AGE is too old for scheduling the frame
+		if (receiver_address == ASK_RECEIVER_BROADCAST_ADDRESS && get_synchronization_header_size(data, size) && us_ticker_read() - _receiver.last_packet_time < (uint32_t)(ASK_TDMA_SYNCHRONIZATION_MAXIMUM_AGE * _us_per_bit))
+		{
+			// frame synchronization packet received, discard old trash from the receiver after processing it
+			process_synchronization_message(sender_address, data, size, join, reserve_address);
+			_synchronization_cached = false;
+			process_pending_messages();
+			_timer.stop();
+			return 0;
+		}
+		else if (size)
 		{
-			// frame synchronization packet received
+			// messages of reliable transfer and async client are processed while waiting for the next frame
+			process_message(receiver_address, sender_address, data, (size_t)size);
+		}
+	}
+	_timer.stop();
 
-			// discard old trash from the receiver
-			discard_all_messages(&_receiver);
+	_base_station_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+	_temporal_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+	_data_slot_available = false;
+	_receiver.rx_address = _reserved_address;
+	_transmitter.tx_address = _reserved_address;
 
-			_base_station_address = sender_address;
+	return ASK_TDMA_ERROR_TIMEOUT;
+}
 
-			_frame_number = data[0] >> 5;
+void ask_tdma_client_t::set_low_power_mode(bool enabled)
+{
+	_low_power = enabled;
+	if (!enabled)
+		_receiver.resume();
+}
+
+void ask_tdma_client_t::sleep_until_next_frame()
+{
+	// packets of reliable transfer and message callback can arrive at any time, so the receiver is not suspended for them.
+	// the next frame can be predicted only from the frame that was received last from the same base station
+	if (_reliable_transfer_active || _message_callback || _base_station_address == ASK_RECEIVER_BROADCAST_ADDRESS || !_clock_sample_valid || _clock_base_station_address != _base_station_address)
+		return;
+
+	// the next frame synchronization packet begins after the data slots of the last frame. its time is measured from the end of the last frame synchronization packet
+	int sleep_bits = _clock_frame_length - (132 + (int)_clock_synchronization_message_size * 12) - ASK_TDMA_LOW_POWER_WAKEUP_MARGIN;
+	uint32_t wakeup_time = _frame_time + base_time_to_local_time(sleep_bits) + (uint32_t)(int32_t)(_clock_offset - 4.0 * sqrt(_clock_jitter));
+	int32_t sleep_time = (int32_t)(wakeup_time - us_ticker_read());
+	if (sleep_time < ASK_TDMA_LOW_POWER_MINIMUM_SLEEP * _us_per_bit)
+		return;
+
+	// messages received before sleeping are processed, the receiver keeps its buffer while suspended
+	process_pending_messages();
+	if (_receiver.suspend(wakeup_time) && sleep_time >= 1000)
+		wait_ms(sleep_time / 1000);
+}
+
+void ask_tdma_client_t::process_synchronization_message(uint8_t sender_address, const uint8_t* data, uint8_t size, bool join, bool reserve_address)
+{
+	// the time of the data slots is calculated from the time the packet ended on air
+	_frame_time = _receiver.last_packet_time;
 
-			uint8_t data_slot_count = data[1] & 0x1F;
+	// frame after missed frames is detected from its number
+	bool consecutive_frame = sender_address == _base_station_address && (data[0] >> 5) == ((_frame_number + 1) & 7);
 
-			for (uint8_t i = data_slot_count; i != 16; ++i)
-				_data_slot_lengths[i] = 0;
+	_base_station_address = sender_address;
 
-			uint8_t rename_count = (size - 2) >> 1;
+	_frame_number = data[0] >> 5;
 
-			for (uint8_t i = 0; i != rename_count; ++i)
-				_data_slot_lengths[data[2 + (i << 1) + 1] & 0xF] = data[2 + (i << 1) + 1] >> 4;
+	uint8_t data_slot_count = data[1] & 0x1F;
 
-			if (join)
+	_data_packet_size = data_packet_sizes[data[1] >> 5];
+
+	for (uint8_t i = data_slot_count; i != 16; ++i)
+		_data_slot_lengths[i] = 0;
+
+	uint8_t header_size = get_synchronization_header_size(data, size);
+
+	bool slot_map = header_size > 2 && (data[2] & ASK_TDMA_SLOT_MAP_FLAG);
+
+	const uint8_t* renames = data + header_size;
+
+	uint8_t rename_count = slot_map ? 0 : (size - header_size) >> 1;
+
+	for (uint8_t i = 0; i != rename_count; ++i)
+		_data_slot_lengths[renames[(i << 1) + 1] & 0xF] = renames[(i << 1) + 1] >> 4;
+
+	// slot map has the whole schedule of the frame
+	const uint8_t* slot_map_addresses = data + header_size;
+	if (slot_map)
+		for (uint8_t i = 0; i != data_slot_count; ++i)
+			_data_slot_lengths[i] = (slot_map_addresses[data_slot_count + (i >> 1)] >> ((i & 1) << 2)) & 0xF;
+
+	// lengths of the data slots are known after slot map or if no frames have been missed since.
+	// base station that does not send extended synchronization messages lists all data slots only when new client joins, so its data slot lengths are assumed to be valid
+	if (slot_map || header_size == 2)
+		_data_slot_lengths_valid = true;
+	else if (!consecutive_frame)
+		_data_slot_lengths_valid = false;
+
+	// number of join slots is 0 for base station that has single join slot for join request of one byte
+	_join_slot_count = (header_size > 2) ? (data[2] & 0x7) + 1 : 0;
+
+	// address and data slot of the client that join bit is send for
+	uint8_t join_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+	uint8_t join_data_slot = 0;
+	if ((data[0] & 0x10) && slot_map && (data[2] >> 4) < data_slot_count)
+	{
+		join_data_slot = data[2] >> 4;
+		join_address = slot_map_addresses[join_data_slot];
+	}
+	else if ((data[0] & 0x10) && rename_count)
+	{
+		join_address = renames[0];
+		join_data_slot = renames[1] & 0xF;
+	}
+
+	// compare the time between frames to their nominal length for clock drift compensation
+	update_clock_estimate(sender_address, _frame_number, size, data_slot_count);
+
+	if (join)
+	{
+		// when joining network test if base station send join bit. client without reserved address knows that its join request was accepted from the identity of the request
+		if (join_address != ASK_RECEIVER_BROADCAST_ADDRESS && (_reserved_address == ASK_RECEIVER_BROADCAST_ADDRESS ? (header_size == 2 || data[3] == _join_identity) : join_address == _reserved_address))
+		{
+			_temporal_address = join_address;
+			_data_slot = join_data_slot;
+			if (reserve_address)
+				_reserved_address = _temporal_address;
+			_receiver.rx_address = _temporal_address;
+			_transmitter.tx_address = _temporal_address;
+		}
+	}
+	else
+	{
+		if (_temporal_address != ASK_RECEIVER_BROADCAST_ADDRESS)
+		{
+			// when being connected to network, the cliend needs to find it's data slot and length of the slot
+
+			if (slot_map)
 			{
-				// when joining network test if base station send join bit
-				if ((data[0] & 0x10) && rename_count && (_reserved_address == ASK_RECEIVER_BROADCAST_ADDRESS || data[2] == _reserved_address))
+				// slot map has the address of the client in its data slot
+				uint8_t data_slot = 0;
+				while (data_slot != data_slot_count && slot_map_addresses[data_slot] != _temporal_address)
+					++data_slot;
+				if (data_slot != data_slot_count)
+					_data_slot = data_slot;
+				else
 				{
-					_temporal_address = data[2];
-					_data_slot = data[3] & 0xF;
-					if (reserve_address)
-						_reserved_address = _temporal_address;
-					_receiver.rx_address = _temporal_address;
-					_transmitter.tx_address = _temporal_address;
+					_temporal_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+					if (!reserve_address)
+						_reserved_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+					_receiver.rx_address = _reserved_address;
+					_transmitter.tx_address = _reserved_address;
 				}
 			}
-			else
-			{
-				if (_temporal_address != ASK_RECEIVER_BROADCAST_ADDRESS)
-				{
-					// when being connected to network, the cliend needs to find it's data slot and length of the slot
 
-					bool data_slot_removed = false;
-					for (uint8_t i = 0; i != rename_count && !data_slot_removed; ++i)
-						if ((data[2 + (i << 1) + 1] & 0xF) == _data_slot)
-							data_slot_removed = true;
+			// renames of frames after missed frames are not used to find the data slot, the client waits for slot map instead
+			bool data_slot_removed = false;
+			for (uint8_t i = 0; i != rename_count && !data_slot_removed && _data_slot_lengths_valid; ++i)
+				if ((renames[(i << 1) + 1] & 0xF) == _data_slot)
+					data_slot_removed = true;
 
-					if (data_slot_removed)
+			if (data_slot_removed)
+			{
+				for (uint8_t i = 0; i != rename_count && data_slot_removed; ++i)
+					if (renames[i << 1] == _temporal_address)
 					{
-						for (uint8_t i = 0; i != rename_count && data_slot_removed; ++i)
-							if (data[2 + (i << 1)] == _temporal_address)
-							{
-								_data_slot = data[2 + (i << 1) + 1] & 0xF;
-								data_slot_removed = false;
-							}
-
-						if (data_slot_removed)
-						{
-							_temporal_address = ASK_RECEIVER_BROADCAST_ADDRESS;
-							if (!reserve_address)
-								_reserved_address = ASK_RECEIVER_BROADCAST_ADDRESS;
-							_receiver.rx_address = _reserved_address;
-							_transmitter.tx_address = _reserved_address;
-						}
+						_data_slot = renames[(i << 1) + 1] & 0xF;
+						data_slot_removed = false;
 					}
 
-					// assume that the client has been disconnected from the network, if this invalid state is reached
-					if ((data[0] & 0x10) && rename_count && data[2] == _temporal_address)
-						_temporal_address = ASK_RECEIVER_BROADCAST_ADDRESS;
-				}
-			}
-			_timer.stop();
+				if (data_slot_removed)
+				{
+					_temporal_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+					if (!reserve_address)
+						_reserved_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+					_receiver.rx_address = _reserved_address;
+					_transmitter.tx_address = _reserved_address;
+				}
+			}
+
+			// assume that the client has been disconnected from the network, if this invalid state is reached
+			if (join_address != ASK_RECEIVER_BROADCAST_ADDRESS && join_address == _temporal_address)
+				_temporal_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+		}
+	}
+
+	if (_temporal_address != ASK_RECEIVER_BROADCAST_ADDRESS && _data_slot_lengths_valid && (_data_slot >= data_slot_count || !_data_slot_lengths[_data_slot]))
+	{
+		// the client has no time allocated to transmit data. it has been disconnected from the network
+		_temporal_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+		if (!reserve_address)
+			_reserved_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+		_receiver.rx_address = _reserved_address;
+		_transmitter.tx_address = _reserved_address;
+	}
+
+
+	// data slot is not used with data slot lengths that may have changed in missed frames, the time of the data slot is not known
+	_data_slot_available = _temporal_address != ASK_RECEIVER_BROADCAST_ADDRESS && _data_slot_lengths_valid;
+}
+
+void ask_tdma_client_t::clock_statistics(ask_tdma_clock_statistics_t* statistics)
+{
+	statistics->base_station_address = _clock_base_station_address;
+	statistics->compensating = _clock_correction != 1.0;
+	statistics->samples = _clock_samples;
+	statistics->samples_rejected = _clock_samples_rejected;
+	statistics->drift_ppm = (float)((_clock_ratio - 1.0) * 1000000.0);
+	statistics->frame_offset_us = (float)_clock_offset;
+	statistics->jitter_us = (float)sqrt(_clock_jitter);
+}
+
+void ask_tdma_client_t::reset_clock_estimate()
+{
+	_clock_sample_valid = false;
+	_clock_base_station_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+	_clock_frame_number = 0;
+	_clock_synchronization_message_size = 0;
+	_clock_frame_length = 0;
+	_clock_frame_time = 0;
+	_clock_samples = 0;
+	_clock_samples_rejected = 0;
+	_clock_sum_weight = 0.0;
+	_clock_sum_x = 0.0;
+	_clock_sum_y = 0.0;
+	_clock_sum_xx = 0.0;
+	_clock_sum_xy = 0.0;
+	_clock_ratio = 1.0;
+	_clock_offset = 0.0;
+	_clock_jitter = 0.0;
+	_clock_correction = 1.0;
+}
+
+void ask_tdma_client_t::update_clock_estimate(uint8_t base_station_address, uint8_t frame_number, uint8_t synchronization_message_size, uint8_t data_slot_count)
+{
+	// estimate starts from beginning with new base station
+	if (base_station_address != _clock_base_station_address)
+	{
+		reset_clock_estimate();
+		_clock_base_station_address = base_station_address;
+	}
+
+	// nominal length of this frame in bits of the base station, next synchronization packet is send after it
+	int frame_length = (132 + (int)synchronization_message_size * 12) + ASK_TDMA_JOIN_SLOTS_LENGTH(_join_slot_count);
+	for (uint8_t i = 0; i != data_slot_count; ++i)
+		frame_length += (int)_data_slot_lengths[i] * ASK_TDMA_DATA_PACKET_LENGTH(_data_packet_size);
 
-			if (_temporal_address != ASK_RECEIVER_BROADCAST_ADDRESS && (_data_slot >= data_slot_count || !_data_slot_lengths[_data_slot]))
+	// only consecutive frames are compared, because lengths of missed frames are unknown
+	if (_clock_sample_valid && frame_number == ((_clock_frame_number + 1) & 7))
+	{
+		// time between the ends of the synchronization packets is the previous frame and the difference of the synchronization packet lengths
+		double nominal_time = (double)(_clock_frame_length + ((int)synchronization_message_size - (int)_clock_synchronization_message_size) * 12) * (double)_us_per_bit;
+		double measured_time = (double)(uint32_t)(_frame_time - _clock_frame_time);
+		double residual = measured_time - (_clock_ratio * nominal_time + _clock_offset);
+		if (residual < 0.0)
+			residual = -residual;
+
+		// frame with wrong slot lengths or lost packets is not used for the estimate
+		if (residual < nominal_time * ASK_TDMA_CLOCK_MAXIMUM_DRIFT + (double)(ASK_TDMA_CLOCK_MAXIMUM_ERROR_BITS * _us_per_bit))
+		{
+			// incremental least squares fit of measured time = ratio * nominal time + offset
+			const double forgetting_factor = 1.0 - 1.0 / (double)ASK_TDMA_CLOCK_ESTIMATE_WINDOW;
+			_clock_sum_weight = forgetting_factor * _clock_sum_weight + 1.0;
+			_clock_sum_x = forgetting_factor * _clock_sum_x + nominal_time;
+			_clock_sum_y = forgetting_factor * _clock_sum_y + measured_time;
+			_clock_sum_xx = forgetting_factor * _clock_sum_xx + nominal_time * nominal_time;
+			_clock_sum_xy = forgetting_factor * _clock_sum_xy + nominal_time * measured_time;
+			_clock_jitter = forgetting_factor * _clock_jitter + (1.0 - forgetting_factor) * residual * residual;
+
+			double mean_x = _clock_sum_x / _clock_sum_weight;
+			double mean_y = _clock_sum_y / _clock_sum_weight;
+			double variance_x = _clock_sum_xx / _clock_sum_weight - mean_x * mean_x;
+			double minimum_spread = (double)(ASK_TDMA_CLOCK_MINIMUM_SPREAD_BITS * _us_per_bit);
+			++_clock_samples;
+
+			// the constant overhead of the base station between frames can be separated from the clock ratio only if the frames have different lengths.
+			// with frames of same length the previous estimate is kept, because the overhead would be mistaken for drift
+			if (variance_x > minimum_spread * minimum_spread)
 			{
-				// the client has no time allocated to transmit data. it has been disconnected from the network
-				_temporal_address = ASK_RECEIVER_BROADCAST_ADDRESS;
-				if (!reserve_address)
-					_reserved_address = ASK_RECEIVER_BROADCAST_ADDRESS;
-				_receiver.rx_address = _reserved_address;
-				_transmitter.tx_address = _reserved_address;
+				_clock_ratio = (_clock_sum_xy / _clock_sum_weight - mean_x * mean_y) / variance_x;
+				_clock_offset = mean_y - _clock_ratio * mean_x;
+				if (_clock_ratio < 1.0 - ASK_TDMA_CLOCK_MAXIMUM_DRIFT)
+					_clock_ratio = 1.0 - ASK_TDMA_CLOCK_MAXIMUM_DRIFT;
+				else if (_clock_ratio > 1.0 + ASK_TDMA_CLOCK_MAXIMUM_DRIFT)
+					_clock_ratio = 1.0 + ASK_TDMA_CLOCK_MAXIMUM_DRIFT;
+				if (_clock_samples >= ASK_TDMA_CLOCK_MINIMUM_SAMPLES)
+					_clock_correction = _clock_ratio;
 			}
-
-			_data_slot_available = _temporal_address != ASK_RECEIVER_BROADCAST_ADDRESS;
-
-			return 0;
 		}
+		else
+			++_clock_samples_rejected;
 	}
-	_timer.stop();
 
-	_base_station_address = ASK_RECEIVER_BROADCAST_ADDRESS;
-	_temporal_address = ASK_RECEIVER_BROADCAST_ADDRESS;
-	_data_slot_available = false;
-	_receiver.rx_address = _reserved_address;
-	_transmitter.tx_address = _reserved_address;
+	_clock_sample_valid = true;
+	_clock_frame_number = frame_number;
+	_clock_synchronization_message_size = synchronization_message_size;
+	_clock_frame_length = frame_length;
+	_clock_frame_time = _frame_time;
+}
 
-	return ASK_TDMA_ERROR_TIMEOUT;
+uint32_t ask_tdma_client_t::base_time_to_local_time(int bits)
+{
+	// converts time in bits of the base station to microseconds of local clock
+	return (uint32_t)((double)(bits * _us_per_bit) * _clock_correction + 0.5);
 }
 
-uint8_t ask_tdma_client_t::wait_for_data_slot()
+uint8_t ask_tdma_client_t::get_data_slot()
 {
 	// test if current frames data slot is used
 	if (_data_slot_available)
@@ -509,20 +1582,23 @@ uint8_t ask_tdma_client_t::wait_for_data_slot()
 		for (uint8_t i = 0; i != _data_slot; ++i)
 			data_slot_lengths += (int)_data_slot_lengths[i];
 
-		int wait_bits = (132 + 1 * 12 + 6) + ((int)data_slot_lengths * (132 + 16 * 12 + 6));
+		int wait_bits = ASK_TDMA_JOIN_SLOTS_LENGTH(_join_slot_count) + ((int)data_slot_lengths * ASK_TDMA_DATA_PACKET_LENGTH(_data_packet_size));
 
-		if ((132 + 26 * 12) + wait_bits > ASK_TDMA_ASSUMED_MAXIMUM_FRAME_LENGTH)
+		if ((132 + 26 * 12) + wait_bits > ASK_TDMA_ASSUMED_MAXIMUM_FRAME_LENGTH(_data_packet_size))
 		{
 			// some thing went wrong
 			return 0;
 		}
 
-		// wait for the time of client's data slot
+		// calculate the time of client's data slot, packets of the slot are scheduled to this time
 
-		wait_us(wait_bits * _us_per_bit);
+		_data_slot_time = _frame_time + base_time_to_local_time(wait_bits);
 
-		// return the length of the data slot
-		return _data_slot_lengths[_data_slot];
+		// return the length of the data slot, packets that do not fit in the scheduled packet buffer are left unused
+		uint8_t data_slot_length = _data_slot_lengths[_data_slot];
+		if (data_slot_length > ASK_TDMA_MAXIMUM_SCHEDULED_DATA_SLOT_LENGTH(_data_packet_size))
+			data_slot_length = (uint8_t)ASK_TDMA_MAXIMUM_SCHEDULED_DATA_SLOT_LENGTH(_data_packet_size);
+		return data_slot_length;
 	}
 	else
 		return 0;
@@ -532,74 +1608,86 @@ int ask_tdma_client_t::join(bool reserve_address)
 {
 	uint32_t join_time_low_part = (uint32_t)time(0);
 
-	if (!_receiver.init(_bit_rate, _rx_pin, _reserved_address))
+	// listening client has the receiver running with frame synchronization packets it has received
+	if (_listening)
+		_receiver.rx_address = _reserved_address;
+	else if (!_receiver.init(_bit_rate, _rx_pin, _reserved_address))
 		return ASK_TDMA_ERROR_RECEIVER_ERROR;
 	if (!_transmitter.init(_bit_rate, _tx_pin, _reserved_address))
 	{
-		_receiver.init(0, NC);
+		shutdown_receiver();
 		return ASK_TDMA_ERROR_TRANSMITTER_ERROR;
 	}
 
 	// initialize xorshift32 state for random join change calculations
 	uint32_t xorshift32_state = initialize_xorshift32(&_receiver);
 
+	// message ids continue from random value, so the base station does not drop messages as duplicates of previous client that had the same address
+	_message_id = (uint8_t)(xorshift32_state >> 24);
+
 	_timer.reset();
 	_timer.start();
 
-	for (int join_requests_failed = 0, join_request_send = 0; _timer.read_us() < ASK_TDMA_TIMEOUT_MULTIPLIER * ASK_TDMA_ASSUMED_MAXIMUM_FRAME_LENGTH * _us_per_bit;)
+	for (int join_requests_failed = 0, backoff_frames = 0, join_request_send = 0; _timer.read_us() < ASK_TDMA_TIMEOUT_MULTIPLIER * ASK_TDMA_ASSUMED_MAXIMUM_FRAME_LENGTH(_data_packet_size) * _us_per_bit;)
 	{
 		// wait for frame synchronization packet and test if join request was successful if it was send
 
 		int error = frame_synchronization(join_request_send != 0, reserve_address);
+
+		// client can not join network with data packets that do not fit in its receiver's or transmitter's buffer
+		if (!error && !is_supported_data_packet_size(_data_packet_size))
+			error = ASK_TDMA_ERROR_INSUFFICIENT_BUFFER;
+
 		if (!error)
 		{
-			if (join_request_send)
-			{
-				if (_temporal_address != ASK_RECEIVER_BROADCAST_ADDRESS)
-				{
-					_timer.stop();
-					return 0;
-				}
-				else if (join_requests_failed < 0xF)
-					++join_requests_failed;
-				join_request_send = 0;
-			}
-
-			// try joining with random change to prevent join packet collisions
-			if (join_requests_failed == 0xF)
-			{
-				xorshift32_state = xorshift32(xorshift32_state);
-				if (!(xorshift32_state & 0xF))
-					xorshift32_state = _receiver.rx_entropy ^ join_time_low_part;
-			}
 			if (!xorshift32_state)
 				xorshift32_state = _receiver.rx_entropy ^ join_time_low_part;
-			xorshift32_state = xorshift32(xorshift32_state);
-			if ((16 - join_requests_failed) > (int)(xorshift32_state & 0xF))
-			{
-				uint8_t join_message = ASK_TDMA_JOIN_MESSAGE | ((uint8_t)(reserve_address ? 1 : 0) << 4) | (_frame_number << 5);
-				_transmitter.send(_base_station_address, &join_message, 1);
-				join_request_send = 1;
 
-				// discard old trash from the receiver
-				discard_all_messages(&_receiver);
+			if (join_request_send && _temporal_address != ASK_RECEIVER_BROADCAST_ADDRESS)
+			{
+				_timer.stop();
+				return 0;
 			}
+
+			// time of the frame that has passed is converted to bits of the base station for the late join request test
+			int elapsed_bits = (int)((double)(int32_t)(us_ticker_read() - _frame_time) / ((double)_us_per_bit * _clock_correction));
+			int join_request_time = get_join_request_time(_join_slot_count, elapsed_bits, join_request_send != 0, &join_requests_failed, &backoff_frames, &xorshift32_state, &_join_identity);
+			join_request_send = 0;
+			if (join_request_time < 0)
+				continue;
+			uint8_t join_message[2] = { (uint8_t)(ASK_TDMA_JOIN_MESSAGE | ((uint8_t)(reserve_address ? 1 : 0) << 4) | (_frame_number << 5)), _join_identity };
+			if (_join_slot_count)
+				_transmitter.send_at(_frame_time + base_time_to_local_time(join_request_time), _base_station_address, join_message, 2);
+			else
+				_transmitter.send_at(_frame_time, _base_station_address, join_message, 1);
+			join_request_send = 1;
+
+			// discard old trash from the receiver
+			discard_all_messages(&_receiver);
 		}
 		else
 		{
 			_timer.stop();
-			_receiver.init(0, NC);
+			shutdown_receiver();
 			_transmitter.init(0, NC);
 			return error;
 		}
 	}
 
 	_timer.stop();
-	_receiver.init(0, NC);
+	shutdown_receiver();
 	_transmitter.init(0, NC);
 	return ASK_TDMA_ERROR_TIMEOUT;
 }
 
+uint8_t ask_tdma_client_t::get_message_id()
+{
+	// message id 0 means message without id, it is never used for messages of the client
+	if (!++_message_id)
+		_message_id = 1;
+	return _message_id;
+}
+
 int ask_tdma_client_t::leave(bool reserve_address)
 {
 	_timer.reset();
@@ -607,13 +1695,16 @@ int ask_tdma_client_t::leave(bool reserve_address)
 
 	int error = 0;
 
-	while (!error && _timer.read_us() < ASK_TDMA_TIMEOUT_MULTIPLIER * ASK_TDMA_ASSUMED_MAXIMUM_FRAME_LENGTH * _us_per_bit)
+	// all retries of the leave message have the same id, so base station processes only one of them
+	uint8_t leave_message_id = get_message_id();
+
+	while (!error && _timer.read_us() < ASK_TDMA_TIMEOUT_MULTIPLIER * ASK_TDMA_ASSUMED_MAXIMUM_FRAME_LENGTH(_data_packet_size) * _us_per_bit)
 	{
 		// send leave packet to base station on next data slot
-		if (wait_for_data_slot())
+		if (get_data_slot())
 		{
 			uint8_t leave_message = ASK_TDMA_LEAVE_MESSAGE | ((uint8_t)(reserve_address ? 1 : 0) << 4) | (_frame_number << 5);
-			_transmitter.send(_base_station_address, &leave_message, 1);
+			_transmitter.send_at(_data_slot_time, _base_station_address, leave_message_id, 0, &leave_message, 1);
 		}
 
 		// wait for frame synchronization packet
@@ -621,14 +1712,14 @@ int ask_tdma_client_t::leave(bool reserve_address)
 		if (!error && _temporal_address == ASK_RECEIVER_BROADCAST_ADDRESS)
 		{
 			_timer.stop();
-			_receiver.init(0, NC);
+			shutdown_receiver();
 			_transmitter.init(0, NC);
 			return 0;
 		}
 	}
 
 	_timer.stop();
-	_receiver.init(0, NC);
+	shutdown_receiver();
 	_transmitter.init(0, NC);
 	_base_station_address = ASK_RECEIVER_BROADCAST_ADDRESS;
 	_temporal_address = ASK_RECEIVER_BROADCAST_ADDRESS;
@@ -641,35 +1732,239 @@ int ask_tdma_client_t::leave(bool reserve_address)
 	return ASK_TDMA_ERROR_TIMEOUT;
 }
 
+ask_tdma_async_client_t::ask_tdma_async_client_t() : _send_queue_space(ASK_TDMA_ASYNC_QUEUE_LENGTH), _thread(osPriorityNormal, ASK_TDMA_ASYNC_CLIENT_STACK_SIZE)
+{
+	_run = false;
+	_started = false;
+	_error = 0;
+	_transfer_message = 0;
+	_transfer_sender = ASK_RECEIVER_BROADCAST_ADDRESS;
+	_transfer_size = 0;
+}
+
+ask_tdma_async_client_t::~ask_tdma_async_client_t()
+{
+	stop();
+}
+
+int ask_tdma_async_client_t::start(PinName rx_pin, PinName tx_pin, int bit_rate)
+{
+	// thread of the client can be started only once
+	if (_started)
+		return ASK_TDMA_ERROR_INVALID_PARAMETER;
+
+	int error = _client.init(rx_pin, tx_pin, bit_rate);
+	if (error)
+		return error;
+
+	// messages are passed to the async client when the client thread is waiting for frames
+	_client._message_callback = process_message;
+	_client._message_callback_context = this;
+
+	_run = true;
+	_started = true;
+	if (_thread.start(callback(this, &ask_tdma_async_client_t::run)) != osOK)
+	{
+		_run = false;
+		_client._message_callback = 0;
+		return ASK_TDMA_ERROR_MALFUNCTIONING_NETWORK;
+	}
+	return 0;
+}
+
+void ask_tdma_async_client_t::stop()
+{
+	if (!_run)
+		return;
+
+	// client thread ends its session and exits after current frame
+	_run = false;
+	_thread.join();
+	_client._message_callback = 0;
+	if (_transfer_message)
+	{
+		_recv_queue.free(_transfer_message);
+		_transfer_message = 0;
+	}
+
+	// messages that were not send are discarded, so senders waiting for space in the send queue return
+	for (osEvent event = _send_queue.get(0); event.status == osEventMail; event = _send_queue.get(0))
+	{
+		_send_queue.free((ask_tdma_message_t*)event.value.p);
+		_send_queue_space.release();
+	}
+}
+
+int ask_tdma_async_client_t::send(uint8_t rx_address, size_t message_size, const void* message_data, uint32_t timeout)
+{
+	if (!_run)
+		return ASK_TDMA_ERROR_NO_NETWORK;
+	if (message_size > ASK_TDMA_ASYNC_MAXIMUM_MESSAGE_SIZE)
+		return ASK_TDMA_ERROR_TRANSFER_TOO_LARGE;
+
+	// wait for free space in the send queue. Mail::alloc does not wait, so the free messages are counted by the semaphore
+	if (_send_queue_space.wait(timeout) <= 0)
+		return ASK_TDMA_ERROR_TIMEOUT;
+	if (!_run)
+	{
+		_send_queue_space.release();
+		return ASK_TDMA_ERROR_NO_NETWORK;
+	}
+	ask_tdma_message_t* message = _send_queue.alloc();
+	if (!message)
+	{
+		_send_queue_space.release();
+		return ASK_TDMA_ERROR_TIMEOUT;
+	}
+
+	message->rx_address = rx_address;
+	message->tx_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+	message->size = message_size;
+	memcpy(message->data, message_data, message_size);
+	_send_queue.put(message);
+	return 0;
+}
+
+int ask_tdma_async_client_t::recv(uint32_t timeout, size_t message_buffer_size, void* message_buffer, uint8_t* rx_address, uint8_t* tx_address, size_t* message_received)
+{
+	*message_received = 0;
+	osEvent event = _recv_queue.get(timeout);
+	if (event.status != osEventMail)
+		return ASK_TDMA_ERROR_TIMEOUT;
+
+	ask_tdma_message_t* message = (ask_tdma_message_t*)event.value.p;
+	size_t size = (message->size < message_buffer_size) ? message->size : message_buffer_size;
+	memcpy(message_buffer, message->data, size);
+	*rx_address = message->rx_address;
+	*tx_address = message->tx_address;
+	*message_received = size;
+	bool truncated = size != message->size;
+	_recv_queue.free(message);
+	return truncated ? ASK_TDMA_ERROR_INSUFFICIENT_BUFFER : 0;
+}
+
+int ask_tdma_async_client_t::get_error()
+{
+	return _error;
+}
+
+void ask_tdma_async_client_t::run()
+{
+	int retry_delay = ASK_TDMA_ASYNC_MINIMUM_RETRY_DELAY;
+	while (_run)
+	{
+		// the client stays in session for the whole life of the thread, it joins back to the network if the session ends
+		int error = _client.begin_session(0);
+		_error = error;
+
+		// failure that returns without waiting for the network is retried after a delay, so the thread does not keep the processor busy
+		if (error && error != ASK_TDMA_ERROR_TIMEOUT)
+		{
+			wait_ms(retry_delay);
+			if (retry_delay < ASK_TDMA_ASYNC_MAXIMUM_RETRY_DELAY)
+				retry_delay <<= 1;
+			continue;
+		}
+		retry_delay = ASK_TDMA_ASYNC_MINIMUM_RETRY_DELAY;
+
+		while (_run && !error)
+		{
+			osEvent event = _send_queue.get(0);
+			if (event.status == osEventMail)
+			{
+				// send queued message in the next data slot
+				ask_tdma_message_t* message = (ask_tdma_message_t*)event.value.p;
+				size_t message_send;
+				error = _client.send(message->rx_address, message->size, message->data, &message_send);
+				_send_queue.free(message);
+				_send_queue_space.release();
+			}
+			else
+				error = _client.maintain_session();
+			_error = error;
+		}
+	}
+	_client.end_session();
+}
+
+void ask_tdma_async_client_t::process_message(void* context, uint8_t receiver_address, uint8_t sender_address, const uint8_t* message, size_t message_size)
+{
+	// this is called only from the client thread, so state of the transfer being received is not shared
+	ask_tdma_async_client_t* client = (ask_tdma_async_client_t*)context;
+
+	if (message_size == 4 && (message[0] & 0x1F) == ASK_TDMA_TRANSFER_MESSAGE && sender_address != client->_client._transmitter.tx_address)
+	{
+		// new transfer replaces unfinished transfer
+		if (client->_transfer_message)
+			client->_recv_queue.free(client->_transfer_message);
+
+		// the transfer is dropped if it is too large or the receive queue is full
+		client->_transfer_size = (size_t)message[1] | ((size_t)message[2] << 8) | ((size_t)message[3] << 16);
+		client->_transfer_message = (client->_transfer_size <= ASK_TDMA_ASYNC_MAXIMUM_MESSAGE_SIZE) ? client->_recv_queue.alloc(0) : 0;
+		if (client->_transfer_message)
+		{
+			client->_transfer_message->rx_address = receiver_address;
+			client->_transfer_message->tx_address = sender_address;
+			client->_transfer_message->size = 0;
+			client->_transfer_sender = sender_address;
+			if (!client->_transfer_size)
+			{
+				client->_recv_queue.put(client->_transfer_message);
+				client->_transfer_message = 0;
+			}
+		}
+	}
+	else if (message_size && (message[0] & 0xF) == ASK_TDMA_EXPRESS_MESSAGE && sender_address != client->_client._transmitter.tx_address)
+	{
+		// express message is passed to the receive queue at once, without interrupting unfinished transfer
+		ask_tdma_message_t* express_message = (message_size - 1 <= ASK_TDMA_ASYNC_MAXIMUM_MESSAGE_SIZE) ? client->_recv_queue.alloc(0) : 0;
+		if (express_message)
+		{
+			express_message->rx_address = receiver_address;
+			express_message->tx_address = sender_address;
+			express_message->size = message_size - 1;
+			memcpy(express_message->data, message + 1, message_size - 1);
+			client->_recv_queue.put(express_message);
+		}
+	}
+	else if (client->_transfer_message && message_size && (message[0] & 0xF) == ASK_TDMA_DATA_MESSAGE && sender_address == client->_transfer_sender && receiver_address == client->_transfer_message->rx_address)
+	{
+		// data packet received add it's data to the message
+		size_t size = message_size - 1;
+		if (size > client->_transfer_size - client->_transfer_message->size)
+			size = client->_transfer_size - client->_transfer_message->size;
+		memcpy(client->_transfer_message->data + client->_transfer_message->size, message + 1, size);
+		client->_transfer_message->size += size;
+
+		if (client->_transfer_message->size == client->_transfer_size)
+		{
+			// transfer completed, pass the message to the receive queue
+			client->_recv_queue.put(client->_transfer_message);
+			client->_transfer_message = 0;
+		}
+		else if (!(message[0] & 0x10))
+		{
+			// last packet received and some data is missing
+			client->_recv_queue.free(client->_transfer_message);
+			client->_transfer_message = 0;
+		}
+	}
+}
+
 #define ASK_TDMA_SLOT_USAGE_MAXIMUM 16
 
-typedef struct ask_tdma_data_slot_t
-{
-	uint8_t address;
-	uint8_t length;
-	int8_t usage;
-	uint8_t frame_usage;
-	bool transfer_ended;
-	bool keep_address_reserved;
-	bool rejoin_notification;
-} ask_tdma_data_slot_t;
-
-typedef struct ask_tdma_server_t
-{
-	uint8_t data_slot_count;
-	uint8_t frame_number;
-	ask_tdma_data_slot_t data_slots[16];
-	uint8_t message_buffer[34];
-	uint8_t reserved_addresses[32];
-	uint8_t rename_count;
-	uint8_t renames[32];
-	int bit_rate;
-	int us_per_bit;
-	uint32_t xorshift32_state;
-	bool run;
-	ask_receiver_t receiver;
-	ask_transmitter_t transmitter;
-} ask_tdma_server_t;
+// length of data slot is send in 4 bits
+#define ASK_TDMA_MAXIMUM_DATA_SLOT_LENGTH 15
+
+// every client has at least one data packet in the frame and clients wait at most the assumed maximum frame length for the next frame
+#if ASK_TDMA_FRAME_DATA_PACKET_BUDGET < 16 || ASK_TDMA_FRAME_DATA_PACKET_BUDGET > 16 * ASK_TDMA_TIMEOUT_MULTIPLIER
+#error "ASK_TDMA_FRAME_DATA_PACKET_BUDGET needs to be from 16 to 16 * ASK_TDMA_TIMEOUT_MULTIPLIER"
+#endif
+
+// number of join slots is send in 3 bits of extended synchronization message
+#if ASK_TDMA_DEFAULT_JOIN_SLOT_COUNT < 1 || ASK_TDMA_DEFAULT_JOIN_SLOT_COUNT > ASK_TDMA_MAXIMUM_JOIN_SLOT_COUNT
+#error "ASK_TDMA_DEFAULT_JOIN_SLOT_COUNT needs to be from 1 to ASK_TDMA_MAXIMUM_JOIN_SLOT_COUNT"
+#endif
 
 static void reserve_address(uint8_t* reserved_addresses, uint8_t address)
 {
@@ -702,7 +1997,46 @@ static bool get_free_address(const uint8_t* reserved_addresses, uint8_t* address
 	return false;
 }
 
-static void process_frame_requests(ask_tdma_server_t* server, uint8_t synchronization_message_size, ask_tdma_data_slot_t* join_request)
+static void update_data_slot_backlog(ask_tdma_data_slot_t* data_slot, const uint8_t* message, size_t message_size)
+{
+	// transfer packet tells how many bytes the client has queued, data packets of the transfer consume it
+	if (message_size >= 5 && (message[0] & 0x1F) == (ASK_TDMA_TRANSFER_MESSAGE | ASK_TDMA_RELIABLE_TRANSFER_FLAG) && message[4])
+	{
+		// transfer packet of reliable transfer is repeated every frame until it is acknowledged, so the repeats of the transfer in progress do not reset the backlog
+		uint32_t transfer_size = (uint32_t)message[1] | ((uint32_t)message[2] << 8) | ((uint32_t)message[3] << 16);
+		if (data_slot->reliable_transfer_chunk_size == message[4] && data_slot->reliable_transfer_size == transfer_size && data_slot->backlog)
+			return;
+		data_slot->reliable_transfer_size = transfer_size;
+		data_slot->reliable_transfer_chunk_size = message[4];
+		data_slot->reliable_transfer_chunks = 0;
+		data_slot->backlog = transfer_size;
+	}
+	else if (message_size >= 4 && (message[0] & 0xF) == ASK_TDMA_TRANSFER_MESSAGE)
+	{
+		data_slot->reliable_transfer_chunk_size = 0;
+		data_slot->backlog = (uint32_t)message[1] | ((uint32_t)message[2] << 8) | ((uint32_t)message[3] << 16);
+	}
+	else if ((message[0] & 0xF) == ASK_TDMA_DATA_MESSAGE && (message[0] & 0x10))
+		data_slot->backlog -= (data_slot->backlog < (uint32_t)message_size - 1) ? data_slot->backlog : (uint32_t)message_size - 1;
+	else if ((message[0] & 0xF) == ASK_TDMA_SEQUENCED_DATA_MESSAGE && message_size >= 3)
+	{
+		// chunks are send in order and only retransmissions go back, so the backlog is what follows the highest chunk and every chunk is counted once
+		uint16_t chunk = (uint16_t)message[1] | ((uint16_t)message[2] << 8);
+		if (data_slot->reliable_transfer_chunk_size && chunk >= data_slot->reliable_transfer_chunks)
+		{
+			data_slot->reliable_transfer_chunks = chunk + 1;
+			uint32_t transfered = (uint32_t)data_slot->reliable_transfer_chunks * (uint32_t)data_slot->reliable_transfer_chunk_size;
+			data_slot->backlog = (transfered < data_slot->reliable_transfer_size) ? data_slot->reliable_transfer_size - transfered : 0;
+		}
+	}
+	else if ((message[0] & 0xF) != ASK_TDMA_ACKNOWLEDGEMENT_MESSAGE)
+	{
+		data_slot->reliable_transfer_chunk_size = 0;
+		data_slot->backlog = 0;
+	}
+}
+
+static void begin_frame(ask_tdma_server_t* server, uint8_t synchronization_message_size)
 {
 	// discard messages from before the frame
 	discard_all_messages(&server->receiver);
@@ -713,65 +2047,103 @@ static void process_frame_requests(ask_tdma_server_t* server, uint8_t synchroniz
 		server->data_slots[i].transfer_ended = false;
 		server->data_slots[i].rejoin_notification = false;
 	}
-	int join_request_count = 0;
-	bool keep_join_address_reserved = false;
-	bool join_request_rejoin_notification = false;
-	uint8_t join_request_address = ASK_RECEIVER_BROADCAST_ADDRESS;
-	uint8_t receiver_address = ASK_RECEIVER_BROADCAST_ADDRESS;
-	uint8_t sender_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+	server->join_request_count = 0;
+	server->join_request_rejoin_notification = false;
 
 	// calculate length of current frame
-	int frame_length = (132 + (int)synchronization_message_size * 12) + 150;
+	int frame_length = (132 + (int)synchronization_message_size * 12) + ((int)server->join_slot_count * ASK_TDMA_JOIN_SLOT_LENGTH);
 	for (uint8_t i = 0; i != server->data_slot_count; ++i)
-		frame_length += (int)server->data_slots[i].length * 330;
-	frame_length *= server->us_per_bit;
+		frame_length += (int)server->data_slots[i].length * ASK_TDMA_DATA_PACKET_LENGTH(server->data_packet_size);
+	server->frame_length = frame_length * server->us_per_bit;
+}
 
-	Timer timer;
-	timer.start();
-	while (timer.read_us() < frame_length)
+static void process_frame_message(ask_tdma_server_t* server, uint8_t receiver_address, uint8_t sender_address, size_t message_size)
+{
+	// here base station processes a message send in the current frame
+	if (message_size && sender_address != server->receiver.rx_address)
 	{
-		// here base station processes all messages send in the current frame
-
-		size_t message_size = server->receiver.recv(&receiver_address, &sender_address, server->message_buffer, 34);
-		if (message_size && sender_address != server->receiver.rx_address)
-		{
-			uint8_t data_slot_address = (uint8_t)~0;
-			if (sender_address != ASK_RECEIVER_BROADCAST_ADDRESS)
-				for (uint8_t i = 0; data_slot_address == (uint8_t)~0 && i != server->data_slot_count; ++i)
-					if (server->data_slots[i].address == sender_address)
+		uint8_t data_slot_address = (uint8_t)~0;
+		if (sender_address != ASK_RECEIVER_BROADCAST_ADDRESS)
+			for (uint8_t i = 0; data_slot_address == (uint8_t)~0 && i != server->data_slot_count; ++i)
+				if (server->data_slots[i].address == sender_address)
+				{
+					// process message from client that is connected to the network
+					server->data_slots[i].frame_usage++;
+					update_data_slot_backlog(server->data_slots + i, server->message_buffer, message_size);
+					if (receiver_address == server->receiver.rx_address && message_size && (server->message_buffer[0] & 0xF) == ASK_TDMA_LEAVE_MESSAGE)
 					{
-						// process message from client that is connected to the network
-						server->data_slots[i].frame_usage++;
-						if (receiver_address == server->receiver.rx_address && message_size && (server->message_buffer[0] & 0xF) == ASK_TDMA_LEAVE_MESSAGE)
-						{
-							server->data_slots[i].usage = -128;
-							server->data_slots[i].keep_address_reserved = (server->message_buffer[0] & 0x10) != 0;
-						}
-						else if (message_size && (server->message_buffer[0] & 0xF) == ASK_TDMA_DATA_MESSAGE && !(server->message_buffer[0] & 0x10))
-							server->data_slots[i].transfer_ended = true;
-						data_slot_address = i;
+						server->data_slots[i].usage = -128;
+						server->data_slots[i].keep_address_reserved = (server->message_buffer[0] & 0x10) != 0;
 					}
-			if ((server->message_buffer[0] & 0xF) == ASK_TDMA_JOIN_MESSAGE)
-			{
-				// process message from client that is trying to connect to the network
-				if (data_slot_address != (uint8_t)~0)
-				{
-					server->data_slots[data_slot_address].rejoin_notification = true;
-					join_request_rejoin_notification = true;
+					else if (receiver_address == server->receiver.rx_address && message_size && (server->message_buffer[0] & 0xF) == ASK_TDMA_KEEPALIVE_MESSAGE && server->data_slots[i].usage != -128)
+					{
+						// client in session keeps its data slot with keepalive messages. the slot is not used for data, so it can be shortened
+						server->data_slots[i].usage = ASK_TDMA_SLOT_USAGE_MAXIMUM;
+						server->data_slots[i].transfer_ended = true;
+					}
+					else if (message_size && (((server->message_buffer[0] & 0xF) == ASK_TDMA_DATA_MESSAGE && !(server->message_buffer[0] & 0x10)) || (server->message_buffer[0] & 0xF) == ASK_TDMA_EXPRESS_MESSAGE))
+						server->data_slots[i].transfer_ended = true;
+					data_slot_address = i;
 				}
-				else
+		if ((server->message_buffer[0] & 0xF) == ASK_TDMA_JOIN_MESSAGE)
+		{
+			// process message from client that is trying to connect to the network
+			if (data_slot_address != (uint8_t)~0)
+			{
+				server->data_slots[data_slot_address].rejoin_notification = true;
+				server->join_request_rejoin_notification = true;
+			}
+			else
+			{
+				// join requests from different join slots of the frame are stored, the identity is 0 for join request of one byte
+				if (server->join_request_count < ASK_TDMA_MAXIMUM_JOIN_SLOT_COUNT)
 				{
-					keep_join_address_reserved = (server->message_buffer[0] & 0x10) != 0;
-					join_request_address = sender_address;
+					server->join_request_addresses[server->join_request_count] = sender_address;
+					server->join_request_identities[server->join_request_count] = (message_size > 1) ? server->message_buffer[1] : 0;
+					server->join_request_keep_address_reserved[server->join_request_count] = (server->message_buffer[0] & 0x10) != 0;
 				}
-				++join_request_count;
+				++server->join_request_count;
 			}
 		}
 	}
-	timer.stop();
+}
+
+static int select_join_request(const ask_tdma_server_t* server)
+{
+	// join request can be accepted only if the client that send it knows it from the frame synchronization message.
+	// client with reserved address is known by its address and other clients by the identity of their join request
+	if (server->join_request_rejoin_notification || server->join_request_count > ASK_TDMA_MAXIMUM_JOIN_SLOT_COUNT)
+		return -1;
+	for (int i = 0; i != server->join_request_count; ++i)
+	{
+		bool unique = true;
+		for (int j = 0; unique && j != server->join_request_count; ++j)
+			if (j != i && server->join_request_addresses[j] == server->join_request_addresses[i] &&
+				(server->join_request_addresses[i] != ASK_RECEIVER_BROADCAST_ADDRESS || !server->join_request_identities[i] || server->join_request_identities[j] == server->join_request_identities[i] || !server->join_request_identities[j]))
+				unique = false;
+		if (unique)
+			return i;
+	}
+	return -1;
+}
+
+static void end_frame(ask_tdma_server_t* server, ask_tdma_data_slot_t* join_request)
+{
+	int join_request_index = select_join_request(server);
+	bool keep_join_address_reserved = (join_request_index != -1) ? server->join_request_keep_address_reserved[join_request_index] : false;
+	uint8_t join_request_address = (join_request_index != -1) ? server->join_request_addresses[join_request_index] : ASK_RECEIVER_BROADCAST_ADDRESS;
+	server->join_request_identity = (join_request_index != -1) ? server->join_request_identities[join_request_index] : 0;
+	server->slot_map_requested = false;
+
 	for (uint8_t i = 0; i != server->data_slot_count; ++i)
 		if (server->data_slots[i].address != ASK_RECEIVER_BROADCAST_ADDRESS)
 		{
+			// count frames since the client last used its data slot
+			if (server->data_slots[i].frame_usage)
+				server->data_slots[i].idle_frames = 0;
+			else if (server->data_slots[i].idle_frames != 0xFF)
+				server->data_slots[i].idle_frames++;
+
 			// update client data slot usage information.
 			if (server->data_slots[i].frame_usage && server->data_slots[i].frame_usage <= server->data_slots[i].length && server->data_slots[i].usage != -128)
 			{
@@ -779,11 +2151,17 @@ static void process_frame_requests(ask_tdma_server_t* server, uint8_t synchroniz
 					server->data_slots[i].usage++;
 			}
 			else if (!server->data_slots[i].frame_usage && server->data_slots[i].usage != -128)
+			{
+				// client that did not use its data slot while it had data left to send or missed its keepalive message may have missed frames and waits for slot map, it is send in the next frame.
+				// client in session without data uses its data slot only every ASK_TDMA_KEEPALIVE_INTERVAL + 1 frames, so shorter idle periods do not request the slot map
 				server->data_slots[i].usage--;
+				if (server->data_slots[i].backlog || server->data_slots[i].idle_frames > ASK_TDMA_KEEPALIVE_INTERVAL)
+					server->slot_map_requested = true;
+			}
 			else
 				server->data_slots[i].usage = -128;
 		}
-	if (join_request_count == 1 && !join_request_rejoin_notification)
+	if (join_request_index != -1)
 	{
 		// if new client is trying to join the network accept the join request
 		if (join_request_address == ASK_RECEIVER_BROADCAST_ADDRESS)
@@ -796,6 +2174,9 @@ static void process_frame_requests(ask_tdma_server_t* server, uint8_t synchroniz
 				join_request->length = 1;
 				join_request->usage = 0;
 				join_request->frame_usage = 0;
+				join_request->idle_frames = 0;
+				join_request->backlog = 0;
+				join_request->reliable_transfer_chunk_size = 0;
 				join_request->transfer_ended = false;
 				join_request->keep_address_reserved = keep_join_address_reserved;
 				join_request->rejoin_notification = false;
@@ -806,6 +2187,9 @@ static void process_frame_requests(ask_tdma_server_t* server, uint8_t synchroniz
 				join_request->length = 0;
 				join_request->usage = -128;
 				join_request->frame_usage = 0;
+				join_request->idle_frames = 0;
+				join_request->backlog = 0;
+				join_request->reliable_transfer_chunk_size = 0;
 				join_request->transfer_ended = false;
 				join_request->keep_address_reserved = false;
 				join_request->rejoin_notification = false;
@@ -819,6 +2203,9 @@ static void process_frame_requests(ask_tdma_server_t* server, uint8_t synchroniz
 			join_request->length = 1;
 			join_request->usage = 0;
 			join_request->frame_usage = 0;
+			join_request->idle_frames = 0;
+			join_request->backlog = 0;
+			join_request->reliable_transfer_chunk_size = 0;
 			join_request->transfer_ended = false;
 			join_request->keep_address_reserved = keep_join_address_reserved;
 			join_request->rejoin_notification = false;
@@ -830,12 +2217,88 @@ static void process_frame_requests(ask_tdma_server_t* server, uint8_t synchroniz
 		join_request->length = 0;
 		join_request->usage = -128;
 		join_request->frame_usage = 0;
+		join_request->idle_frames = 0;
+		join_request->backlog = 0;
+		join_request->reliable_transfer_chunk_size = 0;
 		join_request->transfer_ended = false;
 		join_request->keep_address_reserved = false;
 		join_request->rejoin_notification = false;
 	}
 }
 
+static void allocate_data_slot_lengths(ask_tdma_server_t* server)
+{
+	// demand of a client is the number of data packets needed for its backlog, client without backlog keeps one data packet for new transfers and keepalive messages
+	// client can not use more data packets than it can schedule at once
+	uint32_t data_packet_payload = (uint32_t)server->data_packet_size - 1;
+	uint32_t maximum_demand = (ASK_TDMA_MAXIMUM_SCHEDULED_DATA_SLOT_LENGTH(server->data_packet_size) < ASK_TDMA_MAXIMUM_DATA_SLOT_LENGTH) ? ASK_TDMA_MAXIMUM_SCHEDULED_DATA_SLOT_LENGTH(server->data_packet_size) : ASK_TDMA_MAXIMUM_DATA_SLOT_LENGTH;
+	uint8_t demands[16];
+	int client_count = 0;
+	int total_demand = 0;
+	for (uint8_t i = 0; i != 16; ++i)
+	{
+		demands[i] = 0;
+		if (i < server->data_slot_count && server->data_slots[i].address != ASK_RECEIVER_BROADCAST_ADDRESS)
+		{
+			uint32_t demand = (server->data_slots[i].backlog + data_packet_payload - 1) / data_packet_payload;
+			if (!demand)
+				demand = 1;
+			demands[i] = (uint8_t)((demand < maximum_demand) ? demand : maximum_demand);
+			total_demand += (int)demands[i];
+			client_count++;
+		}
+	}
+
+	// if the demands do not fit in the frame, every client gets one data packet and the rest are shared in proportion to the demands above that
+	uint8_t lengths[16];
+	if (total_demand <= ASK_TDMA_FRAME_DATA_PACKET_BUDGET)
+		for (uint8_t i = 0; i != 16; ++i)
+			lengths[i] = demands[i];
+	else
+	{
+		int extra_budget = ASK_TDMA_FRAME_DATA_PACKET_BUDGET - client_count;
+		int extra_demand = total_demand - client_count;
+		int allocated = 0;
+		for (uint8_t i = 0; i != 16; ++i)
+		{
+			lengths[i] = demands[i] ? (uint8_t)(1 + ((int)demands[i] - 1) * extra_budget / extra_demand) : 0;
+			allocated += (int)lengths[i];
+		}
+
+		// data packets left from rounding go to the clients that have the most demand left
+		while (allocated < ASK_TDMA_FRAME_DATA_PACKET_BUDGET)
+		{
+			uint8_t m = 16;
+			for (uint8_t i = 0; i != 16; ++i)
+				if (demands[i] > lengths[i] && (m == 16 || demands[i] - lengths[i] > demands[m] - lengths[m]))
+					m = i;
+			if (m == 16)
+				break;
+			lengths[m]++;
+			allocated++;
+		}
+	}
+
+	// changed lengths are send in renames, data slot that is already renamed gets the new length in its rename
+	for (uint8_t i = 0; i != server->data_slot_count; ++i)
+		if (demands[i] && lengths[i] != server->data_slots[i].length)
+		{
+			uint8_t rename = 0;
+			while (rename != server->rename_count && (server->renames[(rename << 1) + 1] & 0xF) != i)
+				++rename;
+			if (rename == server->rename_count)
+			{
+				// the length is not changed if it can not be send
+				if (server->rename_count == 16)
+					continue;
+				server->renames[(rename << 1)] = server->data_slots[i].address;
+				server->rename_count++;
+			}
+			server->data_slots[i].length = lengths[i];
+			server->renames[(rename << 1) + 1] = i | (lengths[i] << 4);
+		}
+}
+
 static bool process_frame_renaming(ask_tdma_server_t* server, const ask_tdma_data_slot_t* join_request)
 {
 	bool join_request_accepted = false;
@@ -853,6 +2316,7 @@ static bool process_frame_renaming(ask_tdma_server_t* server, const ask_tdma_dat
 			if (!server->data_slots[i].length)
 				server->data_slots[i].length = 1;
 			server->data_slots[i].usage = 1;
+			server->data_slots[i].idle_frames = 0;
 			server->renames[(server->rename_count << 1)] = server->data_slots[i].address;
 			server->renames[(server->rename_count << 1) + 1] = i | (server->data_slots[i].length << 4);
 			server->rename_count++;
@@ -937,17 +2401,6 @@ static bool process_frame_renaming(ask_tdma_server_t* server, const ask_tdma_dat
 		}
 	}
 
-	// if no renaming optimize data slot lengths by shortening data slot of probably leaving clients
-	if (!server->rename_count)
-		for (uint8_t i = 0; i != server->data_slot_count; ++i)
-			if (server->data_slots[i].address != ASK_RECEIVER_BROADCAST_ADDRESS && server->data_slots[i].length > 1 && server->data_slots[i].transfer_ended)
-			{
-				server->data_slots[i].length = 1;
-				server->renames[(server->rename_count << 1)] = server->data_slots[i].address;
-				server->renames[(server->rename_count << 1) + 1] = i | (server->data_slots[i].length << 4);
-				server->rename_count++;
-			}
-
 	// if no renaming optimize data slot order by removing empty slot from between used slots
 	if (!server->rename_count)
 		for (uint8_t i = 0; i != server->data_slot_count && !server->rename_count; ++i)
@@ -969,16 +2422,8 @@ static bool process_frame_renaming(ask_tdma_server_t* server, const ask_tdma_dat
 						server->rename_count++;
 					}
 
-	// if no renaming optimize data slot lengths by giving longer data slots to clients that use them
-	if (!server->rename_count)
-		for (uint8_t i = 0; i != server->data_slot_count && !server->rename_count; ++i)
-			if (server->data_slots[i].address != ASK_RECEIVER_BROADCAST_ADDRESS && server->data_slots[i].usage && !server->data_slots[i].transfer_ended && server->data_slots[i].length < 4)
-			{
-				server->data_slots[i].length++;
-				server->renames[(server->rename_count << 1)] = server->data_slots[i].address;
-				server->renames[(server->rename_count << 1) + 1] = i | (server->data_slots[i].length << 4);
-				server->rename_count++;
-			}
+	// lengths of the data slots are allocated from the backlogs of the clients
+	allocate_data_slot_lengths(server);
 
 	// find last used data slot
 	server->data_slot_count = 0;
@@ -986,42 +2431,59 @@ static bool process_frame_renaming(ask_tdma_server_t* server, const ask_tdma_dat
 		if (server->data_slots[i].address != ASK_RECEIVER_BROADCAST_ADDRESS)
 			server->data_slot_count = i + 1;
 
-	// when new client joins it needs to know lengths of other data slot so it can calculate time for it's data slot
-	if (join_request_accepted)
-		for (uint8_t i = 0; i != server->data_slot_count; ++i)
-		{
-			bool renamed = false;
-			for (uint8_t j = 0; !renamed && j != server->rename_count; ++j)
-				if (server->renames[j << 1] == server->data_slots[i].address)
-					renamed = true;
-			if (!renamed)
-			{
-				server->renames[(server->rename_count << 1)] = server->data_slots[i].address;
-				server->renames[(server->rename_count << 1) + 1] = i | (server->data_slots[i].length << 4);
-				server->rename_count++;
-			}
-		}
-
+	// when new client joins it needs to know lengths of other data slot so it can calculate time for it's data slot, they are send in slot map of the frame.
+	// the rename of the client that join bit is send for is the first rename
 	return join_request_accepted;
 }
 
 static uint8_t write_frame_synchronization_message(ask_tdma_server_t* server, bool join_request_accepted)
 {
-	server->message_buffer[0] = ASK_TDMA_SYNCHRONIZATION_MESSAGE | (join_request_accepted ? 0x10 : 0) | (server->frame_number << 5);
-	server->message_buffer[1] = server->data_slot_count;
-	for (uint8_t i = 0, e = server->rename_count << 1; i != e; ++i)
-		server->message_buffer[2 + i] = server->renames[i];
-	return 2 + (server->rename_count << 1);
+	// slot map is send instead of renames when join bit is send, every ASK_TDMA_SLOT_MAP_INTERVAL frames and after idle frame of client for clients that have missed frames and when it is not larger than the renames
+	bool slot_map = join_request_accepted || server->slot_map_requested || !(server->frame_count % ASK_TDMA_SLOT_MAP_INTERVAL) || ASK_TDMA_SLOT_MAP_SIZE(server->data_slot_count) <= (server->rename_count << 1);
+
+	// only header and slot map of the message are written to the message buffer, renames are send directly from the renames buffer
+	uint8_t header_size = join_request_accepted ? 4 : 3;
+	server->message_buffer[0] = ASK_TDMA_EXTENDED_SYNCHRONIZATION_MESSAGE | (join_request_accepted ? 0x10 : 0) | (server->frame_number << 5);
+	server->message_buffer[1] = server->data_slot_count | (server->data_packet_size_index << 5);
+	server->message_buffer[2] = (server->join_slot_count - 1) | (slot_map ? ASK_TDMA_SLOT_MAP_FLAG : 0) | ((join_request_accepted && server->rename_count) ? ((server->renames[1] & 0xF) << 4) : 0);
+	server->message_buffer[3] = server->join_request_identity;
+	if (!slot_map)
+		return header_size + (server->rename_count << 1);
+
+	uint8_t* slot_map_addresses = server->message_buffer + header_size;
+	for (uint8_t i = 0; i != server->data_slot_count; ++i)
+		slot_map_addresses[i] = server->data_slots[i].address;
+	for (uint8_t i = 0; i < server->data_slot_count; i += 2)
+		slot_map_addresses[server->data_slot_count + (i >> 1)] = (server->data_slots[i].length & 0xF) | ((i + 1 != server->data_slot_count) ? (server->data_slots[i + 1].length << 4) : 0);
+	return header_size + ASK_TDMA_SLOT_MAP_SIZE(server->data_slot_count);
+}
+
+static bool send_frame_synchronization_message(ask_tdma_server_t* server, uint8_t synchronization_message_size)
+{
+	// message with slot map is whole in the message buffer
+	uint8_t header_size = get_synchronization_header_size(server->message_buffer, synchronization_message_size);
+	if (server->message_buffer[2] & ASK_TDMA_SLOT_MAP_FLAG)
+		return server->transmitter.send(ASK_RECEIVER_BROADCAST_ADDRESS, server->message_buffer, synchronization_message_size, ASK_TRANSMITTER_PRIORITY_HIGH);
+	ask_transmitter_buffer_t synchronization_message[2] = { { server->message_buffer, header_size }, { server->renames, (size_t)server->rename_count << 1 } };
+	return server->transmitter.sendv(ASK_RECEIVER_BROADCAST_ADDRESS, synchronization_message, 2, ASK_TRANSMITTER_PRIORITY_HIGH);
 }
 
-static int start_server(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t base_station_address, ask_tdma_server_t* server)
+static int start_server(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t base_station_address, size_t data_packet_size, int join_slot_count, ask_tdma_server_t* server)
 {
 	// test if parameters are correct for starting a base station
-	if (rx_pin == NC || tx_pin == NC || !server->receiver.is_valid_frequency(bit_rate) || !server->transmitter.is_valid_frequency(bit_rate))
+	if (rx_pin == NC || tx_pin == NC || !server->receiver.is_valid_frequency(bit_rate) || !server->transmitter.is_valid_frequency(bit_rate) || join_slot_count < 1 || join_slot_count > ASK_TDMA_MAXIMUM_JOIN_SLOT_COUNT)
+		return ASK_TDMA_ERROR_INVALID_PARAMETER;
+
+	// data packet size needs to be one of the sizes that can be send in synchronization message and whole data packet needs to fit in the receiver's and the transmitter's buffers
+	uint8_t data_packet_size_index = 0;
+	while (data_packet_size_index != 8 && data_packet_sizes[data_packet_size_index] != data_packet_size)
+		++data_packet_size_index;
+	if (data_packet_size_index == 8 || !is_supported_data_packet_size(data_packet_size))
 		return ASK_TDMA_ERROR_INVALID_PARAMETER;
 
 	// start base station ASK receiver and transmitter
-	if (!server->receiver.init(bit_rate, rx_pin, ASK_RECEIVER_BROADCAST_ADDRESS, true))
+	// receiver drops repeated messages from clients by their message ids
+	if (!server->receiver.init(bit_rate, rx_pin, ASK_RECEIVER_BROADCAST_ADDRESS, true, ASK_RECEIVER_FLAG_DUPLICATE_FILTER))
 		return ASK_TDMA_ERROR_RECEIVER_ERROR;
 	if (!server->transmitter.init(bit_rate, tx_pin))
 	{
@@ -1056,6 +2518,9 @@ static int start_server(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t ba
 		server->data_slots[i].length = 0;
 		server->data_slots[i].usage = 0;
 		server->data_slots[i].frame_usage = 0;
+		server->data_slots[i].idle_frames = 0;
+		server->data_slots[i].backlog = 0;
+		server->data_slots[i].reliable_transfer_chunk_size = 0;
 		server->data_slots[i].keep_address_reserved = false;
 		server->data_slots[i].rejoin_notification = false;
 	}
@@ -1064,44 +2529,129 @@ static int start_server(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t ba
 	server->data_slot_count = 0;
 	server->frame_number = 0;
 	server->rename_count = 0;
+	server->data_packet_size = (uint8_t)data_packet_size;
+	server->data_packet_size_index = data_packet_size_index;
 	server->bit_rate = bit_rate;
 	server->us_per_bit = 1000000 / server->bit_rate;
-	server->run = true;
+	server->frame_count = 0;
+	server->join_slot_count = (uint8_t)join_slot_count;
+	server->join_request_identity = 0;
+	server->slot_map_requested = false;
 	server->receiver.rx_address = base_station_address;
 	server->transmitter.tx_address = base_station_address;
 
 	return 0;
 }
 
-int ask_tdma_host_network(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t base_station_address)
+ask_tdma_base_station_t::ask_tdma_base_station_t()
+{
+	_running = false;
+}
+
+ask_tdma_base_station_t::~ask_tdma_base_station_t()
+{
+	stop();
+}
+
+int ask_tdma_base_station_t::start(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t base_station_address, size_t data_packet_size)
 {
-	ask_tdma_server_t server;
-	int error = start_server(rx_pin, tx_pin, bit_rate, base_station_address, &server);
+	return start(rx_pin, tx_pin, bit_rate, base_station_address, data_packet_size, ASK_TDMA_DEFAULT_JOIN_SLOT_COUNT);
+}
+
+int ask_tdma_base_station_t::start(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t base_station_address, size_t data_packet_size, int join_slot_count)
+{
+	// restarting creates a new network
+	stop();
+
+	int error = start_server(rx_pin, tx_pin, bit_rate, base_station_address, data_packet_size, join_slot_count, &_server);
 	if (error)
 		return error;
 
-	ask_tdma_data_slot_t join_request;
+	// the first frame has no synchronization message and no data slots
+	begin_frame(&_server, 0);
+	_frame_timer.reset();
+	_frame_timer.start();
+	_running = true;
+	return 0;
+}
+
+int ask_tdma_base_station_t::step()
+{
+	if (!_running)
+		return ASK_TDMA_ERROR_NO_NETWORK;
 
-	for (uint8_t synchronization_message_size = 0; !error && server.run;)
+	// process messages that clients have send in the current frame so far
+	uint8_t receiver_address;
+	uint8_t sender_address;
+	ask_receiver_status_t status;
+	_server.receiver.status(&status);
+	for (int i = 0; i != status.packets_available; ++i)
 	{
-		// process the messages send by clients in the frame
-		process_frame_requests(&server, synchronization_message_size, &join_request);
+		size_t message_size = _server.receiver.recv(&receiver_address, &sender_address, _server.message_buffer, sizeof(_server.message_buffer));
+		process_frame_message(&_server, receiver_address, sender_address, message_size);
+	}
+
+	if (_frame_timer.read_us() < _server.frame_length)
+		return 0;
 
-		// do renaming of data slot for next frame
-		bool join_request_accepted = process_frame_renaming(&server, (join_request.usage < 0) ? 0 : &join_request);
+	// the frame is over, update data slots and join requests of the frame
+	ask_tdma_data_slot_t join_request;
+	end_frame(&_server, &join_request);
 
-		// write next synchronization message
-		synchronization_message_size = write_frame_synchronization_message(&server, join_request_accepted);
-		server.frame_number++;
+	// do renaming of data slot for next frame
+	bool join_request_accepted = process_frame_renaming(&_server, (join_request.usage < 0) ? 0 : &join_request);
 
-		// begin new frame by sendin a synchronization message
-		server.transmitter.send(ASK_RECEIVER_BROADCAST_ADDRESS, server.message_buffer, (size_t)synchronization_message_size);
-	}
-	// exit network hosting if error occurs
+	// write next synchronization message
+	uint8_t synchronization_message_size = write_frame_synchronization_message(&_server, join_request_accepted);
+	_server.frame_number++;
+	_server.frame_count++;
+
+	// begin new frame by sendin a synchronization message
+	send_frame_synchronization_message(&_server, synchronization_message_size);
+	_frame_timer.reset();
+	begin_frame(&_server, synchronization_message_size);
+	return 0;
+}
+
+void ask_tdma_base_station_t::stop()
+{
+	if (!_running)
+		return;
+
+	// shutdown base station ASK receiver and transmitter, clients notice that the network is gone when frame synchronization messages stop
+	_running = false;
+	_frame_timer.stop();
+	_server.receiver.init(0, NC);
+	_server.transmitter.init(0, NC);
+}
 
-	// shutdown base station ASK receiver and transmitter
-	server.receiver.init(0, NC);
-	server.transmitter.init(0, NC);
+void ask_tdma_base_station_t::status(ask_tdma_base_station_status_t* current_status)
+{
+	current_status->running = _running;
+	current_status->address = _running ? _server.receiver.rx_address : ASK_RECEIVER_BROADCAST_ADDRESS;
+	current_status->frame_number = _running ? _server.frame_number : 0;
+	current_status->frame_count = _running ? _server.frame_count : 0;
+	current_status->data_slot_count = _running ? _server.data_slot_count : 0;
+	current_status->client_count = 0;
+	if (_running)
+		for (uint8_t i = 0; i != _server.data_slot_count; ++i)
+			if (_server.data_slots[i].address != ASK_RECEIVER_BROADCAST_ADDRESS)
+				current_status->client_count++;
+	current_status->data_packet_size = _running ? _server.data_packet_size : 0;
+	current_status->time_to_next_frame = (_running && _frame_timer.read_us() < _server.frame_length) ? _server.frame_length - _frame_timer.read_us() : 0;
+}
+
+int ask_tdma_host_network(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t base_station_address)
+{
+	return ask_tdma_host_network(rx_pin, tx_pin, bit_rate, base_station_address, ASK_TDMA_DEFAULT_DATA_PACKET_SIZE);
+}
 
+int ask_tdma_host_network(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t base_station_address, size_t data_packet_size)
+{
+	// host the network in the calling thread until an error occurs
+	ask_tdma_base_station_t base_station;
+	int error = base_station.start(rx_pin, tx_pin, bit_rate, base_station_address, data_packet_size);
+	while (!error)
+		error = base_station.step();
 	return error;
-}
\ No newline at end of file
+}
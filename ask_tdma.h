@@ -1,11 +1,71 @@
 /*
-	Mbed OS ASK TDMA version 1.0.0 2018-08-09 by Santtu Nyman.
+	Mbed OS ASK TDMA version 1.23.5 2026-10-19 by Santtu Nyman.
 	This file is part of mbed-os-ask "https://github.com/Santtu-Nyman/mbed-os-ask".
 
 	Description
 		Some simple tdma protocol implementation made for testing ask receiver and transmitter and educational stuff.
 		
 	Version history
+		version 1.23.5 2026-10-19
+			Maximum age of frame synchronization message that client uses for scheduling the frame is named constant.
+		version 1.23.4 2026-10-19
+			Client decides its join slot, identity, backoff and late join requests in one function that the join simulation test uses too.
+		version 1.23.3 2026-10-19
+			Base station counts chunks of reliable transfer once in data slot backlog and repeated transfer packet does not reset the backlog.
+		version 1.23.2 2026-10-19
+			Send of async client waits for space in the send queue with semaphore, because Mail::alloc does not wait, and the client thread backs off after failures.
+		version 1.23.1 2026-10-19
+			Base station sends slot map for unused data slot only if the client had data left to send or missed its keepalive message.
+		version 1.23.0 2026-10-19
+			Join slots begin with guard interval and clients skip frames where the time of their join request has already passed.
+			Join slots are longer, so clients and base stations of earlier versions with multiple join slots are not compatible.
+		version 1.22.1 2026-10-19
+			Receiver of reliable transfer rejects chunks after the transfer has failed and never writes past the end of its buffer.
+		version 1.22.0 2026-10-19
+			Data packets are always the size of the network's data packets and clients fail to join networks with data packets that do not fit in their buffers.
+		version 1.21.0 2026-10-19
+			Data packets are scheduled to the scheduled packet buffer of the transmitter and data slots are limited to the packets that fit in it.
+		version 1.20.0 2026-10-19
+			Frame synchronization messages have periodic slot map of the whole frame, so clients that missed frames or are joining get the schedule from single frame.
+		version 1.19.0 2026-10-19
+			Base station has multiple join slots per frame and clients back off exponentially after failed join requests.
+			Base station sends extended synchronization messages, that clients of earlier versions do not understand.
+		version 1.18.0 2026-10-19
+			Base station allocates data slot lengths every frame in proportion to the bytes that clients have left in their transfers.
+		version 1.17.0 2026-10-19
+			Base station class ask_tdma_base_station_t added, that hosts a network one frame at a time without blocking.
+		version 1.16.0 2026-10-19
+			Low power mode that suspends the receiver between the frames added.
+		version 1.15.0 2026-10-19
+			Client can listen to the network passively and start operations from cached state of the network.
+		version 1.14.0 2026-10-19
+			Messages that fit to single data packet are send as express messages without transfer packet.
+		version 1.13.0 2026-10-19
+			Random state is initialized from receiver's entropy pool without waiting on every join.
+		version 1.12.0 2026-10-19
+			Client estimates clock drift against the base station and compensates it in scheduling.
+		version 1.11.0 2026-10-19
+			Data slots are scheduled from the time synchronization message ended on air instead of the time it was read from the receiver.
+		version 1.10.0 2026-10-19
+			Streaming send and receive functions added, that read and write the message through callbacks.
+		version 1.9.0 2026-10-19
+			Client receives transfers from multiple senders at the same time.
+		version 1.8.0 2026-10-19
+			Async client added, that runs the client in its own thread and is used through send and receive queues.
+		version 1.7.0 2026-10-19
+			Reliable transfers with selective retransmission of lost chunks added.
+		version 1.6.0 2026-10-19
+			Client sessions added, the client can stay connected to the network between transfers.
+		version 1.5.0 2026-10-19
+			Size of data packets is configurable for the network and it is send in synchronization message.
+		version 1.4.0 2026-10-19
+			Client messages have message ids and base station drops repeated messages.
+		version 1.3.0 2026-10-19
+			Packets of data slot are scheduled to their time instead of waiting for it.
+		version 1.2.0 2026-10-19
+			Synchronization, join and leave messages are send as high priority packets.
+		version 1.1.0 2026-10-19
+			Data and synchronization messages are send from their parts without copying them to single buffer.
 		version 1.0.0 2018-08-09
 			Implementation code commented and minor updates added.
 		version 0.0.1 2018-08-02
@@ -19,8 +79,8 @@
 #define ASK_TDMA_H
 
 #define ASK_TDMA_VERSION_MAJOR 1
-#define ASK_TDMA_VERSION_MINOR 0
-#define ASK_TDMA_VERSION_PATCH 0
+#define ASK_TDMA_VERSION_MINOR 23
+#define ASK_TDMA_VERSION_PATCH 5
 
 #define ASK_TDMA_IS_VERSION_ATLEAST(h, m, l) ((((unsigned long)(h) << 16) | ((unsigned long)(m) << 8) | (unsigned long)(l)) <= ((ASK_TDMA_VERSION_MAJOR << 16) | (ASK_TDMA_VERSION_MINOR << 8) | ASK_TDMA_VERSION_PATCH))
 
@@ -45,6 +105,117 @@
 #define ASK_TDMA_ERROR_TRANSFER_TOO_LARGE 13
 #define ASK_TDMA_ERROR_INSUFFICIENT_BUFFER 14
 #define ASK_TDMA_ERROR_PACKETS_LOST 15
+#define ASK_TDMA_ERROR_STREAM_ABORTED 16
+
+#define ASK_TDMA_DEFAULT_DATA_PACKET_SIZE 16
+#define ASK_TDMA_MAXIMUM_DATA_PACKET_SIZE 248
+
+#ifndef ASK_TDMA_REASSEMBLY_TRANSFER_COUNT
+#define ASK_TDMA_REASSEMBLY_TRANSFER_COUNT 4
+#endif
+
+#ifndef ASK_TDMA_REASSEMBLY_BLOCK_SIZE
+#define ASK_TDMA_REASSEMBLY_BLOCK_SIZE 256
+#endif
+
+#define ASK_TDMA_TRANSFER_STATE_FREE 0
+#define ASK_TDMA_TRANSFER_STATE_RECEIVING 1
+#define ASK_TDMA_TRANSFER_STATE_COMPLETE 2
+#define ASK_TDMA_TRANSFER_STATE_FAILED 3
+
+typedef struct ask_tdma_transfer_t
+{
+	uint8_t state;
+	uint8_t receiver_address;
+	uint8_t sender_address;
+	bool direct;
+	size_t size;
+	size_t received;
+	uint32_t age;
+} ask_tdma_transfer_t;
+
+#define ASK_TDMA_MAXIMUM_JOIN_SLOT_COUNT 8
+
+#ifndef ASK_TDMA_DEFAULT_JOIN_SLOT_COUNT
+#define ASK_TDMA_DEFAULT_JOIN_SLOT_COUNT 4
+#endif
+
+#ifndef ASK_TDMA_SLOT_MAP_INTERVAL
+#define ASK_TDMA_SLOT_MAP_INTERVAL 8
+#endif
+
+#ifndef ASK_TDMA_FRAME_DATA_PACKET_BUDGET
+#define ASK_TDMA_FRAME_DATA_PACKET_BUDGET 32
+#endif
+
+#ifndef ASK_TDMA_ASYNC_MAXIMUM_MESSAGE_SIZE
+#define ASK_TDMA_ASYNC_MAXIMUM_MESSAGE_SIZE 256
+#endif
+
+#ifndef ASK_TDMA_ASYNC_QUEUE_LENGTH
+#define ASK_TDMA_ASYNC_QUEUE_LENGTH 4
+#endif
+
+#ifndef ASK_TDMA_ASYNC_CLIENT_STACK_SIZE
+#define ASK_TDMA_ASYNC_CLIENT_STACK_SIZE 4096
+#endif
+
+typedef struct ask_tdma_clock_statistics_t
+{
+	uint8_t base_station_address;
+	bool compensating;
+	size_t samples;
+	size_t samples_rejected;
+	float drift_ppm;
+	float frame_offset_us;
+	float jitter_us;
+} ask_tdma_clock_statistics_t;
+
+typedef size_t (*ask_tdma_source_callback_t)(void* context, size_t offset, void* buffer, size_t size);
+/*
+	Description
+		Source callback of streamed send. The callback is called with increasing offsets until the whole message is read.
+		The callback is called before the data slot of the frame, so it needs to return quickly.
+	Parameters
+		context
+			Context pointer given to send_stream.
+		offset
+			Offset of the data from the beginning of the message.
+		buffer
+			Pointer to buffer that receives the data.
+		size
+			Number of bytes to read to the buffer.
+	Return
+		Number of bytes read to the buffer. If it is less than size, the transfer is aborted.
+*/
+
+typedef bool (*ask_tdma_sink_callback_t)(void* context, size_t offset, const void* data, size_t size);
+/*
+	Description
+		Sink callback of streamed receive. The callback is called with data of each received data packet in order.
+		The receiver buffers packets while the callback runs, so the callback needs to return before the receiver's buffer is full.
+	Parameters
+		context
+			Context pointer given to recv_stream.
+		offset
+			Offset of the data from the beginning of the message.
+		data
+			Pointer to the received data.
+		size
+			Number of bytes received.
+	Return
+		True to continue receiving the message and false to abort the transfer.
+*/
+
+typedef void (*ask_tdma_message_callback_t)(void* context, uint8_t receiver_address, uint8_t sender_address, const uint8_t* message, size_t message_size);
+
+typedef struct ask_tdma_message_t
+{
+	uint8_t rx_address;
+	uint8_t tx_address;
+	size_t size;
+	uint8_t data[ASK_TDMA_ASYNC_MAXIMUM_MESSAGE_SIZE];
+} ask_tdma_message_t;
 
 class ask_tdma_client_t
 {
@@ -104,6 +275,9 @@ class ask_tdma_client_t
 				Function receives next packet from the network that is send to reserved address of the client or broadcast address.
 				If client does not have a reserved address only broadcasted packets are received.
 				Broadcast address is 0xFF.
+				Transfers from different senders are received at the same time and the transfer that finishes first is returned.
+				Up to ASK_TDMA_REASSEMBLY_TRANSFER_COUNT transfers are reassembled in blocks of ASK_TDMA_REASSEMBLY_BLOCK_SIZE bytes and transfers finished after the message is returned are kept for next call.
+				One transfer larger than the block is received directly to the message buffer.
 			Parameters
 				timeout
 					Specifies timeout of the function in microseconds.
@@ -128,6 +302,7 @@ class ask_tdma_client_t
 			Description
 				Function sends a packet to the network, that contains message given by function parameters.
 				The packet tx address is client's reserved address if it has a reserved address else it is temporal address given by base station.
+				Message that fits to single data packet is send in one packet without separate transfer packet.
 			Parameters
 				rx_address
 					Packet rx address.
@@ -143,11 +318,233 @@ class ask_tdma_client_t
 				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
 		*/
 
+		int recv_stream(int timeout, ask_tdma_sink_callback_t sink, void* context, uint8_t* rx_address, uint8_t* tx_address, size_t* message_received);
+		/*
+			Description
+				Function receives next transfer like recv, but passes data of the message to sink callback as it is received instead of storing the whole message.
+				This is used for messages larger than available memory.
+			Parameters
+				timeout
+					Specifies timeout of the function in microseconds.
+					If timeout is 0 the function does not have time out, but it can return ASK_TDMA_ERROR_TIMEOUT for other reasons.
+				sink
+					Callback that receives the data of the message.
+				context
+					Pointer that is passed to the sink callback.
+				rx_address
+					Pointer to variable that receives packet rx address.
+				tx_address
+					Pointer to variable that receives packet tx address.
+				message_received
+					Pointer to variable that receives number of bytes passed to the sink.
+					This value is valid even if the function fails.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+				If the sink aborts the transfer, the function fails with error ASK_TDMA_ERROR_STREAM_ABORTED.
+		*/
+
+		int send_stream(uint8_t rx_address, size_t message_size, ask_tdma_source_callback_t source, void* context, size_t* message_send);
+		/*
+			Description
+				Function sends message like send, but reads the message from source callback one packet at a time instead of from a buffer.
+				This is used for messages larger than available memory.
+			Parameters
+				rx_address
+					Packet rx address.
+					Broadcast address is 0xFF.
+				message_size
+					Size of the message to be send. Maximum size of the message is 16777215 bytes.
+				source
+					Callback that reads the data of the message.
+				context
+					Pointer that is passed to the source callback.
+				message_send
+					Pointer to variable that receives number of bytes send.
+					This value is valid even if the function fails.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+				If the source does not read all the data requested, the function fails with error ASK_TDMA_ERROR_STREAM_ABORTED.
+		*/
+
+		int send_reliable(uint8_t rx_address, size_t message_size, const void* message_data, size_t* message_send, int timeout);
+		/*
+			Description
+				Function sends a message reliably to single client, that receives it with recv_reliable.
+				The message is send in chunks that have sequence numbers and the receiver acknowledges received chunks every frame.
+				Only the chunks that are missing from the acknowledgements are send again, so a lost packet does not cause the whole message to be send again.
+			Parameters
+				rx_address
+					Packet rx address. Broadcast address can not be used for reliable transfer.
+				message_size
+					Size of the message to be send. Maximum size of the message is 16777215 bytes and 65535 chunks.
+				message_data
+					Pointer to buffer that contain the message to be send.
+				message_send
+					Pointer to variable that receives number of bytes the receiver has acknowledged.
+					This value is valid even if the function fails.
+				timeout
+					Specifies timeout for the transfer in microseconds.
+					If timeout is 0 the function does not have time out, but it can return ASK_TDMA_ERROR_TIMEOUT for other reasons.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+		*/
+
+		int recv_reliable(int timeout, size_t message_buffer_size, void* message_buffer, uint8_t* rx_address, uint8_t* tx_address, size_t* message_received);
+		/*
+			Description
+				Function receives a message that is send with send_reliable.
+				The client joins the network for the transfer, because it sends acknowledgements in its data slot.
+				Chunks are written directly to their place in the message buffer, so they can be received in any order.
+			Parameters
+				timeout
+					Specifies timeout for the transfer in microseconds.
+					If timeout is 0 the function does not have time out, but it can return ASK_TDMA_ERROR_TIMEOUT for other reasons.
+				message_buffer_size
+					Size of buffer pointed by message_buffer.
+					If the message is larger than the buffer, the function fails with error ASK_TDMA_ERROR_INSUFFICIENT_BUFFER.
+				message_buffer
+					Pointer to buffer that receives the message.
+				rx_address
+					Pointer to variable that receives packet rx address.
+				tx_address
+					Pointer to variable that receives packet tx address.
+				message_received
+					Pointer to variable that receives number of bytes received from the beginning of the message.
+					This value is valid even if the function fails.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+		*/
+
+		void clock_statistics(ask_tdma_clock_statistics_t* statistics);
+		/*
+			Description
+				Gets statistics of clock drift estimation of the client.
+				The client compares times between consecutive frame synchronization packets to nominal lengths of the frames.
+				From these the ratio of the client's clock to the base station's clock is estimated and used for scheduling data slots.
+			Parameters
+				statistics
+					Pointer to variable that receives the statistics.
+					base_station_address is the address of the base station that the estimate is for.
+					compensating is true if the estimate is used for scheduling. Drift can be estimated only when lengths of the frames vary.
+					samples is the number of frames used for the estimate and samples_rejected is the number of frames that did not match the estimate.
+					drift_ppm is how much faster the client's clock is than the base station's clock in parts per million.
+					frame_offset_us is estimated constant time in microseconds that the base station uses between frames.
+					jitter_us is root mean square error of the estimate in microseconds.
+			Return
+				This function has no return value.
+		*/
+
+		int begin_session(int idle_timeout);
+		/*
+			Description
+				Function joins the client to the network and begins a session, where the client stays connected to the network between transfers.
+				In session send does not join and leave the network for every message, it only waits for the next frame and sends the message in the client's data slot.
+				If the session is already active, this function only sets new idle timeout for it.
+			Parameters
+				idle_timeout
+					Specifies in microseconds how long the session can be idle before maintain_session ends it.
+					Sending or receiving a message resets the idle time. If idle_timeout is 0 the session does not have idle timeout.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+		*/
+
+		int maintain_session();
+		/*
+			Description
+				Function waits for the next frame of the network and sends keepalive message in the client's data slot, if it is time for it.
+				This function needs to be called repeatedly while the session is active and the client is not sending or receiving, or the base station removes the idle client from the network.
+				If the client has been removed from the network, this function joins it back to the network.
+				If the session has been idle longer than its idle timeout, this function ends the session and fails with error ASK_TDMA_ERROR_TIMEOUT.
+			Parameters
+				This function has no parameters.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+				The session is not active after this function fails.
+		*/
+
+		int end_session();
+		/*
+			Description
+				Function ends the session and leaves the network.
+				If the session is not active, this function does nothing.
+			Parameters
+				This function has no parameters.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+		*/
+
+		int begin_listening();
+		/*
+			Description
+				Function starts passive listening of the network. The receiver of the client keeps running and buffers packets of the network between calls to the client.
+				While listening, the client tracks the base station address, frame number, data slot lengths and clock estimate of the network from every frame synchronization packet.
+				Joining, sending and receiving start from this cached state, and if the latest frame synchronization packet is recent enough the client does not need to wait for the next frame.
+				If the client is already listening, this function does nothing.
+			Parameters
+				This function has no parameters.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+		*/
+
+		int listen();
+		/*
+			Description
+				Function processes the packets received since the last call and updates the cached state of the network.
+				This function does not wait. It should be called regularly while listening, at least once in every frame for the client to start operations without waiting.
+				The cached state of the network is forgotten if no frame synchronization packets have been received for a long time.
+			Parameters
+				This function has no parameters.
+			Return
+				If the cached state of the network is valid, the return value is 0.
+				If the client is not listening or the base station has not been found, the return value is ASK_TDMA_ERROR_NO_NETWORK.
+		*/
+
+		void end_listening();
+		/*
+			Description
+				Function stops passive listening of the network. If the client is not in session, the receiver is shut down.
+				If the client is not listening, this function does nothing.
+			Parameters
+				This function has no parameters.
+			Return
+				This function has no return value.
+		*/
+
+		void set_low_power_mode(bool enabled);
+		/*
+			Description
+				Function enables or disables low power mode of the client.
+				In low power mode the client predicts the start of the next frame synchronization packet from the length of the last frame and the clock estimate,
+				and suspends the receiver and sleeps until shortly before it, when waiting for the next frame.
+				Packets send to the client after its data slot are lost in low power mode, so it should be used by clients that mostly send or use sessions only for sending.
+				The receiver is not suspended while receiving reliable transfer or when the client is used by async client.
+			Parameters
+				enabled
+					Specifies if the low power mode is enabled.
+			Return
+				This function has no return value.
+		*/
+
 	private:
 		int frame_synchronization(bool join, bool reserve_address);
-		uint8_t wait_for_data_slot();
+		void sleep_until_next_frame();
+		void process_synchronization_message(uint8_t sender_address, const uint8_t* data, uint8_t size, bool join, bool reserve_address);
+		uint8_t get_data_slot();
+		uint8_t get_message_id();
 		int join(bool reserve_address);
 		int leave(bool reserve_address);
+		void release_receiver();
+		void shutdown_receiver();
+		int connect();
+		void disconnect();
+		int send_transfer(uint8_t rx_address, size_t message_size, const void* message_data, ask_tdma_source_callback_t source, void* context, size_t* message_send);
+		void reset_clock_estimate();
+		void update_clock_estimate(uint8_t base_station_address, uint8_t frame_number, uint8_t synchronization_message_size, uint8_t data_slot_count);
+		uint32_t base_time_to_local_time(int bits);
+		void drop_direct_transfers();
+		void process_pending_messages();
+		void process_message(uint8_t receiver_address, uint8_t sender_address, const uint8_t* message, size_t message_size);
+		void process_reliable_transfer_message(uint8_t receiver_address, uint8_t sender_address, const uint8_t* message, size_t message_size);
 
 		uint8_t _base_station_address;
 		uint8_t _frame_number;
@@ -156,6 +553,53 @@ class ask_tdma_client_t
 		uint8_t _reserved_address;
 		bool _data_slot_available;
 		uint8_t _data_slot_lengths[16];
+		bool _data_slot_lengths_valid;
+		uint8_t _join_slot_count;
+		uint8_t _join_identity;
+		uint32_t _frame_time;
+		uint32_t _data_slot_time;
+		uint8_t _message_id;
+		uint8_t _data_packet_size;
+		bool _session_active;
+		int _session_idle_timeout;
+		int _session_keepalive_frames;
+		bool _listening;
+		bool _synchronization_cached;
+		bool _low_power;
+		bool _reliable_transfer_active;
+		bool _reliable_transfer_receiving;
+		bool _reliable_transfer_acknowledged;
+		uint8_t _reliable_transfer_address;
+		uint8_t _reliable_transfer_chunk_size;
+		uint16_t _reliable_transfer_chunk_count;
+		uint16_t _reliable_transfer_base;
+		uint32_t _reliable_transfer_bitmap;
+		void* _reliable_transfer_buffer;
+		size_t _reliable_transfer_buffer_size;
+		size_t _reliable_transfer_size;
+		int _reliable_transfer_error;
+		ask_tdma_message_callback_t _message_callback;
+		void* _message_callback_context;
+		ask_tdma_transfer_t _transfers[ASK_TDMA_REASSEMBLY_TRANSFER_COUNT];
+		uint32_t _transfer_age;
+		bool _clock_sample_valid;
+		uint8_t _clock_base_station_address;
+		uint8_t _clock_frame_number;
+		uint8_t _clock_synchronization_message_size;
+		int _clock_frame_length;
+		uint32_t _clock_frame_time;
+		size_t _clock_samples;
+		size_t _clock_samples_rejected;
+		double _clock_sum_weight;
+		double _clock_sum_x;
+		double _clock_sum_y;
+		double _clock_sum_xx;
+		double _clock_sum_xy;
+		double _clock_ratio;
+		double _clock_offset;
+		double _clock_jitter;
+		double _clock_correction;
+		uint8_t _reassembly_blocks[ASK_TDMA_REASSEMBLY_TRANSFER_COUNT][ASK_TDMA_REASSEMBLY_BLOCK_SIZE];
 
 		int _bit_rate;
 		int _us_per_bit;
@@ -163,18 +607,331 @@ class ask_tdma_client_t
 		PinName _tx_pin;
 
 		Timer _timer;
+		Timer _session_timer;
 		ask_receiver_t _receiver;
 		ask_transmitter_t _transmitter;
 
 		// No copying object of this type!
 		ask_tdma_client_t(const ask_tdma_client_t&);
 		ask_tdma_client_t& operator=(const ask_tdma_client_t&);
+
+		friend class ask_tdma_async_client_t;
+};
+
+class ask_tdma_async_client_t
+{
+	public:
+		ask_tdma_async_client_t();
+
+		~ask_tdma_async_client_t();
+		// the destructor calls stop.
+
+		int start(PinName rx_pin, PinName tx_pin, int bit_rate);
+		/*
+			Description
+				Initializes the client and starts a thread that keeps it connected to the network.
+				The thread sends messages from the send queue in the client's data slot and receives messages continuously to the receive queue.
+				The receiver and transmitter are initialized once and they are used by the thread until stop is called.
+				The client can be started only once.
+			Parameters
+				rx_pin
+					Mbed OS pin name for rx pin.
+				tx_pin
+					Mbed OS pin name for tx pin.
+				bit_rate
+					Network bit rate. This value needs to be valid for ask receiver and transmitter.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+		*/
+
+		void stop();
+		/*
+			Description
+				Stops the thread of the client and leaves the network.
+				This function waits until the thread has finished current frame or the delay before it joins the network again after a failure.
+				Messages in the send queue are discarded.
+			Parameters
+				This function has no parameters.
+			Return
+				This function has no return value.
+		*/
+
+		int send(uint8_t rx_address, size_t message_size, const void* message_data, uint32_t timeout);
+		/*
+			Description
+				Copies message to the send queue. The message is sent by the client thread.
+			Parameters
+				rx_address
+					Packet rx address.
+					Broadcast address is 0xFF.
+				message_size
+					Size of the message to be send. Maximum size of the message is ASK_TDMA_ASYNC_MAXIMUM_MESSAGE_SIZE.
+				message_data
+					Pointer to buffer that contain the message to be send.
+				timeout
+					Specifies in milliseconds how long the function waits for space in the send queue.
+					If timeout is osWaitForever the function waits until there is space in the queue.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+				If the send queue is full until timeout, the function fails with error ASK_TDMA_ERROR_TIMEOUT.
+		*/
+
+		int recv(uint32_t timeout, size_t message_buffer_size, void* message_buffer, uint8_t* rx_address, uint8_t* tx_address, size_t* message_received);
+		/*
+			Description
+				Gets next message from the receive queue.
+				Messages are dropped if the receive queue is full or they are larger than ASK_TDMA_ASYNC_MAXIMUM_MESSAGE_SIZE.
+			Parameters
+				timeout
+					Specifies in milliseconds how long the function waits for a message.
+					If timeout is osWaitForever the function waits until a message is received.
+				message_buffer_size
+					Size of buffer pointed by message_buffer.
+				message_buffer
+					Pointer to buffer that receives the message.
+					If the message is larger than the buffer, the message is truncated and the function fails with error ASK_TDMA_ERROR_INSUFFICIENT_BUFFER.
+				rx_address
+					Pointer to variable that receives packet rx address.
+				tx_address
+					Pointer to variable that receives packet tx address.
+				message_received
+					Pointer to variable that receives size of the received message.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+		*/
+
+		int get_error();
+		/*
+			Description
+				Gets the result of the last operation of the client thread.
+			Parameters
+				This function has no parameters.
+			Return
+				The return value is 0 if the client is connected to the network, else it is ASK TDMA error code of the last failed operation.
+				The thread tries to join the network again after every failure. Failures that do not wait for the network, like ASK_TDMA_ERROR_RECEIVER_ERROR, are retried after a delay from 100 ms up to 1600 ms.
+		*/
+
+	private:
+		void run();
+		static void process_message(void* context, uint8_t receiver_address, uint8_t sender_address, const uint8_t* message, size_t message_size);
+
+		volatile bool _run;
+		bool _started;
+		volatile int _error;
+		ask_tdma_message_t* _transfer_message;
+		uint8_t _transfer_sender;
+		size_t _transfer_size;
+
+		Semaphore _send_queue_space;
+		Mail<ask_tdma_message_t, ASK_TDMA_ASYNC_QUEUE_LENGTH> _send_queue;
+		Mail<ask_tdma_message_t, ASK_TDMA_ASYNC_QUEUE_LENGTH> _recv_queue;
+		Thread _thread;
+		ask_tdma_client_t _client;
+
+		// No copying object of this type!
+		ask_tdma_async_client_t(const ask_tdma_async_client_t&);
+		ask_tdma_async_client_t& operator=(const ask_tdma_async_client_t&);
+};
+
+typedef struct ask_tdma_data_slot_t
+{
+	uint8_t address;
+	uint8_t length;
+	int8_t usage;
+	uint8_t frame_usage;
+	uint8_t idle_frames;
+	uint32_t backlog;
+	uint32_t reliable_transfer_size;
+	uint16_t reliable_transfer_chunks;
+	uint8_t reliable_transfer_chunk_size;
+	bool transfer_ended;
+	bool keep_address_reserved;
+	bool rejoin_notification;
+} ask_tdma_data_slot_t;
+
+typedef struct ask_tdma_server_t
+{
+	uint8_t data_slot_count;
+	uint8_t frame_number;
+	ask_tdma_data_slot_t data_slots[16];
+	uint8_t message_buffer[ASK_TDMA_MAXIMUM_DATA_PACKET_SIZE];
+	uint8_t data_packet_size;
+	uint8_t data_packet_size_index;
+	uint8_t reserved_addresses[32];
+	uint8_t rename_count;
+	uint8_t renames[32];
+	int bit_rate;
+	int us_per_bit;
+	uint32_t xorshift32_state;
+	int frame_length;
+	size_t frame_count;
+	uint8_t join_slot_count;
+	uint8_t join_request_identity;
+	bool slot_map_requested;
+	int join_request_count;
+	bool join_request_rejoin_notification;
+	uint8_t join_request_addresses[ASK_TDMA_MAXIMUM_JOIN_SLOT_COUNT];
+	uint8_t join_request_identities[ASK_TDMA_MAXIMUM_JOIN_SLOT_COUNT];
+	bool join_request_keep_address_reserved[ASK_TDMA_MAXIMUM_JOIN_SLOT_COUNT];
+	ask_receiver_t receiver;
+	ask_transmitter_t transmitter;
+} ask_tdma_server_t;
+
+typedef struct ask_tdma_base_station_status_t
+{
+	bool running;
+	uint8_t address;
+	uint8_t frame_number;
+	size_t frame_count;
+	uint8_t data_slot_count;
+	uint8_t client_count;
+	uint8_t data_packet_size;
+	int time_to_next_frame;
+} ask_tdma_base_station_status_t;
+
+class ask_tdma_base_station_t
+{
+	public:
+		ask_tdma_base_station_t();
+
+		~ask_tdma_base_station_t();
+		// the destructor calls stop.
+
+		int start(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t base_station_address, size_t data_packet_size);
+		/*
+			Description
+				Function creates a new network and begins its first frame. If the base station is already running, the old network is stopped first.
+				The network is hosted by calling step repeatedly.
+			Parameters
+				rx_pin
+					Mbed OS pin name for rx pin.
+				tx_pin
+					Mbed OS pin name for tx pin.
+				bit_rate
+					Network bit rate. This value needs to be valid for ask receiver and transmitter.
+					Valid bit rates are 1000, 1250, 2500 and 3125 bit/s.
+				base_station_address
+					Address for the base station.
+					If this parameter is broadcast address the base station chooses a random address.
+				data_packet_size
+					Size of data packet messages in bytes including 1 byte TDMA header.
+					Valid sizes are 16, 32, 48, 64, 96, 128, 192 and 248. The size is also required to fit in ASK_RECEIVER_BUFFER_SIZE of the base station with the 7 byte packet overhead and the packet time and to be at most ASK_TRANSMITTER_MAXIMUM_SCHEDULED_MESSAGE_SIZE.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+		*/
+
+		int start(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t base_station_address, size_t data_packet_size, int join_slot_count);
+		/*
+			Description
+				Function creates a new network with given number of join slots per frame and begins its first frame.
+				Clients that are joining send their join requests in randomly chosen join slot, so more join slots make fewer join requests collide when many clients join at the same time.
+				Every join slot makes the frame 178 bits longer, 16 bits of guard interval and 162 bits of join request. One join request is accepted per frame.
+				The guard interval makes also single join slot 16 bits longer than a join request. In the simulation of tests/host/ask_tdma_join_test.cpp at 1000 bit/s with single join slot,
+				16 clients filled the network in 328.2 s instead of 318.7 s without the guard interval and 128 clients in 205.3 s instead of 194.8 s.
+			Parameters
+				rx_pin
+					Mbed OS pin name for rx pin.
+				tx_pin
+					Mbed OS pin name for tx pin.
+				bit_rate
+					Network bit rate. This value needs to be valid for ask receiver and transmitter.
+					Valid bit rates are 1000, 1250, 2500 and 3125 bit/s.
+				base_station_address
+					Address for the base station.
+					If this parameter is broadcast address the base station chooses a random address.
+				data_packet_size
+					Size of data packet messages in bytes including 1 byte TDMA header.
+					Valid sizes are 16, 32, 48, 64, 96, 128, 192 and 248. The size has the same buffer requirements as with the other start function.
+				join_slot_count
+					Number of join slots per frame from 1 to ASK_TDMA_MAXIMUM_JOIN_SLOT_COUNT.
+					The other start function uses ASK_TDMA_DEFAULT_JOIN_SLOT_COUNT.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+		*/
+
+		int step();
+		/*
+			Description
+				Function processes messages that clients have send in the current frame and, if the current frame is over, begins the next frame by sending frame synchronization message.
+				This function does not wait, so it can be called from an event loop or a thread that does also other work.
+				It needs to be called often, at least few times during every data packet, because the messages of the frame are stored in the receiver's buffer until this function processes them.
+				The time until the next frame is given by status in time_to_next_frame.
+				All member functions of the base station need to be called from the same thread.
+			Parameters
+				This function has no parameters.
+			Return
+				If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+				If the base station is not running, the return value is ASK_TDMA_ERROR_NO_NETWORK.
+		*/
+
+		void stop();
+		/*
+			Description
+				Function stops hosting the network and shuts down the receiver and the transmitter of the base station.
+				Clients notice that the network is gone, when frame synchronization messages stop.
+				If the base station is not running, this function does nothing.
+			Parameters
+				This function has no parameters.
+			Return
+				This function has no return value.
+		*/
+
+		void status(ask_tdma_base_station_status_t* current_status);
+		/*
+			Description
+				Function queries the current state of the base station.
+			Parameters
+				current_status
+					Pointer to variable that receives current status of the base station.
+					running is true if the base station is hosting a network.
+					address is the address of the base station.
+					frame_number is the number of the current frame that is send in frame synchronization messages and frame_count is the number of frames since start.
+					data_slot_count is the number of data slots in the current frame and client_count is the number of clients connected to the network.
+					data_packet_size is the size of data packets of the network.
+					time_to_next_frame is time in microseconds until the current frame is over.
+			Return
+				This function has no return value.
+		*/
+
+	private:
+		bool _running;
+		Timer _frame_timer;
+		ask_tdma_server_t _server;
+
+		// No copying object of this type!
+		ask_tdma_base_station_t(const ask_tdma_base_station_t&);
+		ask_tdma_base_station_t& operator=(const ask_tdma_base_station_t&);
 };
 
 int ask_tdma_host_network(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t base_station_address);
 /*
 	Description
 		Function creates and hosts a network.
+		This function hosts the network in the calling thread and returns only if an error occurs. ask_tdma_base_station_t can be used to host a network that can be stopped.
+	Parameters
+		rx_pin
+			Mbed OS pin name for rx pin.
+		tx_pin
+			Mbed OS pin name for tx pin.
+		bit_rate
+			Network bit rate. This value needs to be valid for ask receiver and transmitter.
+			Valid bit rates are 1000, 1250, 2500 and 3125 bit/s.
+		base_station_address
+			Address for the base station.
+			If this parameter is broadcast address the base station chooses a random address.
+	Return
+		If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
+*/
+
+int ask_tdma_host_network(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t base_station_address, size_t data_packet_size);
+/*
+	Description
+		Function creates and hosts a network with given size of data packets.
+		The size of data packets is send to clients in every frame synchronization message.
+		Clients send data in packets of this size, so the packets of every client fill the time reserved for them in the frame.
+		Clients schedule all packets of their data slot at once, so the data slot of a client is limited to the packets that fit in ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE.
+		Larger data packets have less overhead per byte, but clients need ASK_RECEIVER_BUFFER_SIZE and ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE large enough for them.
+		Clients that can not receive or send the data packets of the network fail to join it with error ASK_TDMA_ERROR_INSUFFICIENT_BUFFER.
 	Parameters
 		rx_pin
 			Mbed OS pin name for rx pin.
@@ -186,6 +943,10 @@ int ask_tdma_host_network(PinName rx_pin, PinName tx_pin, int bit_rate, uint8_t
 		base_station_address
 			Address for the base station.
 			If this parameter is broadcast address the base station chooses a random address.
+		data_packet_size
+			Size of data packet messages in bytes including 1 byte TDMA header.
+			Valid sizes are 16, 32, 48, 64, 96, 128, 192 and 248. The size is also required to fit in ASK_RECEIVER_BUFFER_SIZE of the base station with the 7 byte packet overhead and the packet time and to be at most ASK_TRANSMITTER_MAXIMUM_SCHEDULED_MESSAGE_SIZE.
+			Networks hosted by the other overload of this function have data packet size of ASK_TDMA_DEFAULT_DATA_PACKET_SIZE.
 	Return
 		If the function succeeds, the return value is 0 and ASK TDMA error code on failure.
 */
@@ -1,5 +1,5 @@
 /*
-	Mbed OS ASK transmitter version version 1.3.2 2018-08-01 by Santtu Nyman.
+	Mbed OS ASK transmitter version version 1.14.2 2026-10-19 by Santtu Nyman.
 	This file is part of mbed-os-ask "https://github.com/Santtu-Nyman/mbed-os-ask".
 */
 
@@ -8,6 +8,12 @@
 // pointer to the transmitter for interrupt handler
 static ask_transmitter_t* _ask_transmitter;
 
+// preamble and start symbol as 12-bit words, 6 symbols of 0x2A followed by the start symbol 0x38 0x2C
+static const uint16_t _preamble_and_start_symbol[4] = { 0xAAA, 0xAAA, 0xAAA, 0xB38 };
+
+// priority of packets that are send from the scheduled packet buffer
+#define ASK_TRANSMITTER_PRIORITY_SCHEDULED 2
+
 #ifdef ASK_TRANSMITTER_WIRED_DEBUG_MODE
 // when the transmitter is not sending data tx will have no pull on wired debug mode
 static bool _tx_no_pull;
@@ -30,6 +36,12 @@ ask_transmitter_t::ask_transmitter_t(int tx_frequency, PinName tx_pin, uint8_t n
 	init(tx_frequency, tx_pin, new_tx_address);
 }
 
+ask_transmitter_t::ask_transmitter_t(int tx_frequency, PinName tx_pin, uint8_t new_tx_address, uint32_t flags)
+{
+	_is_initialized = false;
+	init(tx_frequency, tx_pin, new_tx_address, flags);
+}
+
 ask_transmitter_t::~ask_transmitter_t()
 {
 	init(0, NC, ASK_TRANSMITTER_BROADCAST_ADDRESS);
@@ -41,6 +53,11 @@ bool ask_transmitter_t::init(int tx_frequency, PinName tx_pin)
 }
 
 bool ask_transmitter_t::init(int tx_frequency, PinName tx_pin, uint8_t new_tx_address)
+{
+	return init(tx_frequency, tx_pin, new_tx_address, 0);
+}
+
+bool ask_transmitter_t::init(int tx_frequency, PinName tx_pin, uint8_t new_tx_address, uint32_t flags)
 {
 	// shutdown if tx_frequency is 0
 	if (!tx_frequency)
@@ -69,8 +86,8 @@ bool ask_transmitter_t::init(int tx_frequency, PinName tx_pin, uint8_t new_tx_ad
 	if (tx_pin == NC)
 		return false;
 
-	// fail init if invalid frequency
-	if (!is_valid_frequency(tx_frequency))
+	// fail init if invalid frequency or flags
+	if (!is_valid_frequency(tx_frequency) || (flags & ~ASK_TRANSMITTER_VALID_FLAGS))
 		return false;
 
 	// only one transmitter is allowed after version 0.2.0 for simpler implementation this one transmitter is pointed by _ask_transmitter
@@ -100,16 +117,23 @@ bool ask_transmitter_t::init(int tx_frequency, PinName tx_pin, uint8_t new_tx_ad
 		tx_address = new_tx_address;
 
 		// set transmitter initialization parameters
+		_flags = flags;
 		_tx_frequency = tx_frequency;
+		_us_per_bit = 1000000 / tx_frequency;
 		_tx_pin_name = tx_pin;
 
 		_packets_send = 0;
 		_bytes_send = 0;
 
-		// set ring buffer indices to 0
-		_tx_output_symbol_bit_index = 0;
+		// clear output state and set ring buffer indices to 0
+		_tx_output_bit_count = 0;
+		_tx_frame_length = 0;
 		_tx_buffer_read_index = 0;
 		_tx_buffer_write_index = 0;
+		_tx_priority_buffer_read_index = 0;
+		_tx_priority_buffer_write_index = 0;
+		_tx_scheduled_buffer_read_index = 0;
+		_tx_scheduled_buffer_write_index = 0;
 
 		_is_initialized = true;
 
@@ -130,65 +154,64 @@ bool ask_transmitter_t::init(int tx_frequency, PinName tx_pin, uint8_t new_tx_ad
 
 bool ask_transmitter_t::send(uint8_t rx_address, const void* message_data, size_t message_byte_length)
 {
-	static const uint8_t preamble_and_start_symbol[8] = { 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x38, 0x2C };
-
-	if (message_byte_length > ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE || !_is_initialized)
-		return false;
-
-	// the data after the start symbol begins with length of the packet, header rx address, header tx address, header id, header flags
-	// lenght of the packet is (1 byte lenght + 1 byte rx address + 1 byte tx ddress + 1 byte id + 1 byte flags + n bytes message + 2 bytes crc)
-	uint8_t length_and_header[5] = { (uint8_t)(7 + message_byte_length), rx_address, tx_address, 0, 0, };
-
-	// crc init is 0xFFFF
-	uint16_t crc = 0xFFFF;
+	ask_transmitter_buffer_t message = { message_data, message_byte_length };
+	return sendv(rx_address, &message, 1);
+}
 
-	// write preamble and start symbol to output buffer
-	for (size_t i = 0; i != sizeof(preamble_and_start_symbol); ++i)
-		_write_byte_to_buffer(preamble_and_start_symbol[i]);
+bool ask_transmitter_t::send(const void* message_data, size_t message_byte_length)
+{
+	return send(ASK_TRANSMITTER_BROADCAST_ADDRESS, message_data, message_byte_length);
+}
 
-	uint8_t next_byte;
+bool ask_transmitter_t::sendv(uint8_t rx_address, const ask_transmitter_buffer_t* buffers, size_t buffer_count)
+{
+	return sendv(rx_address, buffers, buffer_count, ASK_TRANSMITTER_PRIORITY_NORMAL);
+}
 
-	// write length and header to output buffer
-	for (size_t i = 0; i != sizeof(length_and_header); ++i)
-	{
-		next_byte = length_and_header[i];
-		crc = _kermit.fastCRC(crc, next_byte);
-		_write_byte_to_buffer(_encode_symbol(_high_nibble(next_byte)));
-		_write_byte_to_buffer(_encode_symbol(_low_nibble(next_byte)));
-	}
+bool ask_transmitter_t::send(uint8_t rx_address, const void* message_data, size_t message_byte_length, int priority)
+{
+	ask_transmitter_buffer_t message = { message_data, message_byte_length };
+	return sendv(rx_address, &message, 1, priority);
+}
 
-	// write message data to output buffer
-	for (size_t i = 0; i != message_byte_length; ++i)
-	{
-		next_byte = *(const uint8_t*)((uintptr_t)message_data + i);
-		crc = _kermit.fastCRC(crc, next_byte);
-		_write_byte_to_buffer(_encode_symbol(_high_nibble(next_byte)));
-		_write_byte_to_buffer(_encode_symbol(_low_nibble(next_byte)));
-	}
+bool ask_transmitter_t::sendv(uint8_t rx_address, const ask_transmitter_buffer_t* buffers, size_t buffer_count, int priority)
+{
+	return sendv(rx_address, 0, 0, buffers, buffer_count, priority);
+}
 
-	// crc xorout is 0xFFFF
-	crc ^= 0xFFFF;
+bool ask_transmitter_t::send_at(uint32_t timestamp, uint8_t rx_address, const void* message_data, size_t message_byte_length)
+{
+	ask_transmitter_buffer_t message = { message_data, message_byte_length };
+	return sendv_at(timestamp, rx_address, 0, 0, &message, 1);
+}
 
-	// write crc to output buffer in little endian byte order
-	next_byte = (uint8_t)(crc & 0xFF);
-	_write_byte_to_buffer(_encode_symbol(_high_nibble(next_byte)));
-	_write_byte_to_buffer(_encode_symbol(_low_nibble(next_byte)));
-	next_byte = (uint8_t)(crc >> 8);
-	_write_byte_to_buffer(_encode_symbol(_high_nibble(next_byte)));
-	_write_byte_to_buffer(_encode_symbol(_low_nibble(next_byte)));
+bool ask_transmitter_t::sendv_at(uint32_t timestamp, uint8_t rx_address, const ask_transmitter_buffer_t* buffers, size_t buffer_count)
+{
+	return sendv_at(timestamp, rx_address, 0, 0, buffers, buffer_count);
+}
 
-	// write 0 after the packet to set output low after the packet is send
-	_write_byte_to_buffer(0);
+bool ask_transmitter_t::send(uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const void* message_data, size_t message_byte_length, int priority)
+{
+	ask_transmitter_buffer_t message = { message_data, message_byte_length };
+	return sendv(rx_address, header_id, header_flags, &message, 1, priority);
+}
 
-	++_packets_send;
-	_bytes_send += message_byte_length;
+bool ask_transmitter_t::sendv(uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const ask_transmitter_buffer_t* buffers, size_t buffer_count, int priority)
+{
+	if (priority != ASK_TRANSMITTER_PRIORITY_NORMAL && priority != ASK_TRANSMITTER_PRIORITY_HIGH)
+		return false;
+	return _write_packet(rx_address, header_id, header_flags, buffers, buffer_count, priority, 0);
+}
 
-	return true;
+bool ask_transmitter_t::send_at(uint32_t timestamp, uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const void* message_data, size_t message_byte_length)
+{
+	ask_transmitter_buffer_t message = { message_data, message_byte_length };
+	return sendv_at(timestamp, rx_address, header_id, header_flags, &message, 1);
 }
 
-bool ask_transmitter_t::send(const void* message_data, size_t message_byte_length)
+bool ask_transmitter_t::sendv_at(uint32_t timestamp, uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const ask_transmitter_buffer_t* buffers, size_t buffer_count)
 {
-	return send(ASK_TRANSMITTER_BROADCAST_ADDRESS, message_data, message_byte_length);
+	return _write_packet(rx_address, header_id, header_flags, buffers, buffer_count, ASK_TRANSMITTER_PRIORITY_SCHEDULED, timestamp);
 }
 
 void ask_transmitter_t::status(ask_transmitter_status_t* current_status)
@@ -198,8 +221,9 @@ void ask_transmitter_t::status(ask_transmitter_status_t* current_status)
 		current_status->tx_frequency = _tx_frequency;
 		current_status->tx_pin = _tx_pin_name;
 		current_status->tx_address = tx_address;
+		current_status->flags = _flags;
 		current_status->initialized = true;
-		if (_tx_buffer_read_index != _tx_buffer_write_index || _tx_output_symbol_bit_index)
+		if (_tx_buffer_read_index != _tx_buffer_write_index || _tx_priority_buffer_read_index != _tx_priority_buffer_write_index || _tx_scheduled_buffer_read_index != _tx_scheduled_buffer_write_index || _tx_output_bit_count || _tx_frame_length)
 			current_status->active = true;
 		else
 			current_status->active = false;
@@ -211,6 +235,7 @@ void ask_transmitter_t::status(ask_transmitter_status_t* current_status)
 		current_status->tx_frequency = 0;
 		current_status->tx_pin = NC;
 		current_status->tx_address = ASK_TRANSMITTER_BROADCAST_ADDRESS;
+		current_status->flags = 0;
 		current_status->initialized = false;
 		current_status->active = false;
 		current_status->packets_send = 0;
@@ -218,6 +243,60 @@ void ask_transmitter_t::status(ask_transmitter_status_t* current_status)
 	}
 }
 
+size_t ask_transmitter_t::render(uint8_t rx_address, uint8_t tx_address, const void* message_data, size_t message_byte_length, void* bit_buffer, size_t bit_buffer_size)
+{
+	if (message_byte_length > ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE || bit_buffer_size < ASK_TRANSMITTER_RENDER_BUFFER_SIZE(message_byte_length))
+		return 0;
+
+	CRC16 kermit(0x1021, 0x0000, 0x0000, true, true, FAST_CRC);
+	uint8_t* bitstream = (uint8_t*)bit_buffer;
+	size_t bit_index = 0;
+
+	// clear the buffer, bits are written to it by setting them
+	for (size_t i = 0, e = ASK_TRANSMITTER_RENDER_BUFFER_SIZE(message_byte_length); i != e; ++i)
+		bitstream[i] = 0;
+
+	// write preamble and start symbol to the bitstream
+	for (size_t i = 0; i != sizeof(_preamble_and_start_symbol) / sizeof(uint16_t); ++i)
+		_write_bits_to_bitstream(bitstream, &bit_index, _preamble_and_start_symbol[i], 12);
+
+	// the packet is encoded exactly like by send and the interrupt handler
+	uint8_t length_and_header[5] = { (uint8_t)(7 + message_byte_length), rx_address, tx_address, 0, 0, };
+
+	// crc init is 0xFFFF
+	uint16_t crc = 0xFFFF;
+
+	uint8_t next_byte;
+
+	// write length and header to the bitstream
+	for (size_t i = 0; i != sizeof(length_and_header); ++i)
+	{
+		next_byte = length_and_header[i];
+		crc = kermit.fastCRC(crc, next_byte);
+		_write_bits_to_bitstream(bitstream, &bit_index, _encode_byte(next_byte), 12);
+	}
+
+	// write message data to the bitstream
+	for (size_t i = 0; i != message_byte_length; ++i)
+	{
+		next_byte = *(const uint8_t*)((uintptr_t)message_data + i);
+		crc = kermit.fastCRC(crc, next_byte);
+		_write_bits_to_bitstream(bitstream, &bit_index, _encode_byte(next_byte), 12);
+	}
+
+	// crc xorout is 0xFFFF
+	crc ^= 0xFFFF;
+
+	// write crc to the bitstream in little endian byte order
+	_write_bits_to_bitstream(bitstream, &bit_index, _encode_byte((uint8_t)(crc & 0xFF)), 12);
+	_write_bits_to_bitstream(bitstream, &bit_index, _encode_byte((uint8_t)(crc >> 8)), 12);
+
+	// 6 low bits after the packet are already cleared
+	bit_index += 6;
+
+	return bit_index;
+}
+
 bool ask_transmitter_t::is_valid_frequency(int frequency)
 {
 	static const int valid_frequencies[] = { 1000, 1250, 2500, 3125 };
@@ -233,11 +312,11 @@ bool ask_transmitter_t::is_valid_frequency(int frequency)
 
 void ask_transmitter_t::_tx_interrupt_handler()
 {
-	// read next byte if !symbol_bit_index and if no data to send return from this function
-	uint8_t symbol_bit_index = _ask_transmitter->_tx_output_symbol_bit_index;
+	// load next word if all bits of the current word are send and if no data to send return from this function
+	uint8_t bit_count = _ask_transmitter->_tx_output_bit_count;
 
 #ifdef ASK_TRANSMITTER_WIRED_DEBUG_MODE
-	if (!symbol_bit_index && !_ask_transmitter->_read_byte_from_buffer(&_ask_transmitter->_tx_output_symbol))
+	if (!bit_count && !_ask_transmitter->_load_next_output_word())
 	{
 		if (!_tx_no_pull)
 		{
@@ -258,37 +337,171 @@ void ask_transmitter_t::_tx_interrupt_handler()
 		_tx_no_pull = false;
 	}
 #else
-	if (!symbol_bit_index && !_ask_transmitter->_read_byte_from_buffer(&_ask_transmitter->_tx_output_symbol))
+	if (!bit_count && !_ask_transmitter->_load_next_output_word())
 		return;
 #endif
 
 	// send next bit if there is more data to send.
-	
-	uint8_t symbol = _ask_transmitter->_tx_output_symbol;
-	
-	// set the tx pin voltage(low or high) to the value of bit number symbol_bit_index of symbol and incroment symbol_bit_index to index of next bit.
-	gpio_write(&_ask_transmitter->_tx_pin, (int)((symbol >> symbol_bit_index++) & 1));
 
-	// after sending 6 low bits of current byte start sending next byte
-	if (symbol_bit_index == 6)
-		symbol_bit_index = 0;
-	_ask_transmitter->_tx_output_symbol_bit_index = symbol_bit_index;
+	if (!bit_count)
+		bit_count = _ask_transmitter->_tx_output_bit_count;
+
+	uint16_t word = _ask_transmitter->_tx_output_word;
+
+	// set the tx pin voltage(low or high) to the value of the lowest bit of the word and shift the next bit to its place.
+	gpio_write(&_ask_transmitter->_tx_pin, (int)(word & 1));
+	_ask_transmitter->_tx_output_word = word >> 1;
+	_ask_transmitter->_tx_output_bit_count = bit_count - 1;
 }
 
-uint8_t ask_transmitter_t::_high_nibble(uint8_t byte)
+uint16_t ask_transmitter_t::_encode_byte(uint8_t byte)
 {
-	return byte >> 4;
+	// table of both 4b6b symbols of every byte, symbol of the high nibble is in the low 6 bits since it is send first
+	static const uint16_t symbol_pair_table[256] = {
+		0x34D, 0x38D, 0x4CD, 0x54D, 0x58D, 0x64D, 0x68D, 0x70D, 0x8CD, 0x94D, 0x98D, 0xA4D, 0xA8D, 0xB0D, 0xC8D, 0xD0D,
+		0x34E, 0x38E, 0x4CE, 0x54E, 0x58E, 0x64E, 0x68E, 0x70E, 0x8CE, 0x94E, 0x98E, 0xA4E, 0xA8E, 0xB0E, 0xC8E, 0xD0E,
+		0x353, 0x393, 0x4D3, 0x553, 0x593, 0x653, 0x693, 0x713, 0x8D3, 0x953, 0x993, 0xA53, 0xA93, 0xB13, 0xC93, 0xD13,
+		0x355, 0x395, 0x4D5, 0x555, 0x595, 0x655, 0x695, 0x715, 0x8D5, 0x955, 0x995, 0xA55, 0xA95, 0xB15, 0xC95, 0xD15,
+		0x356, 0x396, 0x4D6, 0x556, 0x596, 0x656, 0x696, 0x716, 0x8D6, 0x956, 0x996, 0xA56, 0xA96, 0xB16, 0xC96, 0xD16,
+		0x359, 0x399, 0x4D9, 0x559, 0x599, 0x659, 0x699, 0x719, 0x8D9, 0x959, 0x999, 0xA59, 0xA99, 0xB19, 0xC99, 0xD19,
+		0x35A, 0x39A, 0x4DA, 0x55A, 0x59A, 0x65A, 0x69A, 0x71A, 0x8DA, 0x95A, 0x99A, 0xA5A, 0xA9A, 0xB1A, 0xC9A, 0xD1A,
+		0x35C, 0x39C, 0x4DC, 0x55C, 0x59C, 0x65C, 0x69C, 0x71C, 0x8DC, 0x95C, 0x99C, 0xA5C, 0xA9C, 0xB1C, 0xC9C, 0xD1C,
+		0x363, 0x3A3, 0x4E3, 0x563, 0x5A3, 0x663, 0x6A3, 0x723, 0x8E3, 0x963, 0x9A3, 0xA63, 0xAA3, 0xB23, 0xCA3, 0xD23,
+		0x365, 0x3A5, 0x4E5, 0x565, 0x5A5, 0x665, 0x6A5, 0x725, 0x8E5, 0x965, 0x9A5, 0xA65, 0xAA5, 0xB25, 0xCA5, 0xD25,
+		0x366, 0x3A6, 0x4E6, 0x566, 0x5A6, 0x666, 0x6A6, 0x726, 0x8E6, 0x966, 0x9A6, 0xA66, 0xAA6, 0xB26, 0xCA6, 0xD26,
+		0x369, 0x3A9, 0x4E9, 0x569, 0x5A9, 0x669, 0x6A9, 0x729, 0x8E9, 0x969, 0x9A9, 0xA69, 0xAA9, 0xB29, 0xCA9, 0xD29,
+		0x36A, 0x3AA, 0x4EA, 0x56A, 0x5AA, 0x66A, 0x6AA, 0x72A, 0x8EA, 0x96A, 0x9AA, 0xA6A, 0xAAA, 0xB2A, 0xCAA, 0xD2A,
+		0x36C, 0x3AC, 0x4EC, 0x56C, 0x5AC, 0x66C, 0x6AC, 0x72C, 0x8EC, 0x96C, 0x9AC, 0xA6C, 0xAAC, 0xB2C, 0xCAC, 0xD2C,
+		0x372, 0x3B2, 0x4F2, 0x572, 0x5B2, 0x672, 0x6B2, 0x732, 0x8F2, 0x972, 0x9B2, 0xA72, 0xAB2, 0xB32, 0xCB2, 0xD32,
+		0x374, 0x3B4, 0x4F4, 0x574, 0x5B4, 0x674, 0x6B4, 0x734, 0x8F4, 0x974, 0x9B4, 0xA74, 0xAB4, 0xB34, 0xCB4, 0xD34 };
+	return symbol_pair_table[byte];
 }
 
-uint8_t ask_transmitter_t::_low_nibble(uint8_t byte)
+void ask_transmitter_t::_write_bits_to_bitstream(uint8_t* bitstream, size_t* bit_index, uint16_t bits, uint8_t bit_count)
 {
-	return byte & 0xF;
+	// the bits are send starting from the lowest bit, in the bitstream they are stored starting from the most significant bit of each byte
+	size_t index = *bit_index;
+	for (uint8_t i = 0; i != bit_count; ++i, ++index)
+		if ((bits >> i) & 1)
+			bitstream[index >> 3] |= (uint8_t)(0x80 >> (index & 7));
+	*bit_index = index;
 }
 
-uint8_t ask_transmitter_t::_encode_symbol(uint8_t _4bit_data)
+bool ask_transmitter_t::_begin_next_packet()
 {
-	static const uint8_t symbol_table[16] = { 0x0D, 0x0E, 0x13, 0x15, 0x16, 0x19, 0x1A, 0x1C, 0x23, 0x25, 0x26, 0x29, 0x2A, 0x2C, 0x32, 0x34 };
-	return symbol_table[_4bit_data];
+	// begin next packet if there is one, first byte of every packet in the buffers is the length of the packet
+	// scheduled packets are send at their time, high priority packets are send before normal priority packets
+	// scheduled and high priority packets are always completely written to their buffers
+	uint8_t next_byte = 0;
+	bool scheduled_packet = _tx_scheduled_buffer_read_index != _tx_scheduled_buffer_write_index;
+	int32_t time_to_start = 0;
+	if (scheduled_packet)
+	{
+		uint32_t start_time = 0;
+		for (size_t i = 0; i != 4; ++i)
+			start_time |= (uint32_t)_peek_byte_from_scheduled_buffer(i) << (i << 3);
+		time_to_start = (int32_t)(start_time - us_ticker_read());
+		if (time_to_start <= 0)
+		{
+			// discard the time stamp of the packet before reading its length
+			_tx_scheduled_buffer_read_index = (_tx_scheduled_buffer_read_index + 4) % ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE;
+			_read_byte_from_scheduled_buffer(&next_byte);
+			_tx_frame_priority = ASK_TRANSMITTER_PRIORITY_SCHEDULED;
+			_tx_frame_length = next_byte;
+			_tx_frame_word_index = 0;
+			return true;
+		}
+	}
+
+	// it is not yet time to send the scheduled packet, so the next other packet can be send before it, if it is send completely before the scheduled packet
+	// the length of the next packet is available, if its buffer is not empty
+	int32_t bits_per_byte = (_flags & ASK_TRANSMITTER_FLAG_SCRAMBLED_NRZ) ? 8 : 12;
+	if (_tx_priority_buffer_read_index != _tx_priority_buffer_write_index)
+	{
+		if (scheduled_packet && time_to_start <= (48 + (int32_t)_tx_priority_buffer[_tx_priority_buffer_read_index] * bits_per_byte + 6 + 1) * _us_per_bit)
+			return false;
+		_read_byte_from_priority_buffer(&next_byte);
+		_tx_frame_priority = ASK_TRANSMITTER_PRIORITY_HIGH;
+	}
+	else if (_tx_buffer_read_index != _tx_buffer_write_index)
+	{
+		if (scheduled_packet && time_to_start <= (48 + (int32_t)_tx_buffer[_tx_buffer_read_index] * bits_per_byte + 6 + 1) * _us_per_bit)
+			return false;
+		_read_byte_from_buffer(&next_byte);
+		_tx_frame_priority = ASK_TRANSMITTER_PRIORITY_NORMAL;
+	}
+	else
+		return false;
+	_tx_frame_length = next_byte;
+	_tx_frame_word_index = 0;
+	return true;
+}
+
+bool ask_transmitter_t::_load_next_output_word()
+{
+	if (!_tx_frame_length && !_begin_next_packet())
+		return false;
+
+	uint8_t next_byte = 0;
+	uint16_t word_index = _tx_frame_word_index;
+	if (word_index == 4 + (uint16_t)_tx_frame_length)
+	{
+		// the packet is send
+		_tx_frame_length = 0;
+		if ((_flags & ASK_TRANSMITTER_FLAG_BURST_MODE) && _begin_next_packet())
+		{
+			// in burst mode packet that is ready to be send follows the previous packet with only the start symbol before it
+			word_index = 3;
+		}
+		else
+		{
+			// send 6 low bits after the packet to set output low after the packet is send
+			_tx_output_word = 0;
+			_tx_output_bit_count = 6;
+			return true;
+		}
+	}
+
+	if (word_index < 4)
+	{
+		// send preamble and start symbol before the packet
+		_tx_output_word = _preamble_and_start_symbol[word_index];
+		_tx_output_bit_count = 12;
+	}
+	else
+	{
+		if (word_index == 4)
+		{
+			// the length is already read from the buffer and the scrambler starts from its seed at the first byte of the packet
+			next_byte = _tx_frame_length;
+			_tx_scrambler_state = ASK_SCRAMBLER_SEED;
+		}
+		else
+		{
+			// encode next byte of the packet. if it is not yet written to the buffer wait for it
+			bool byte_read;
+			if (_tx_frame_priority == ASK_TRANSMITTER_PRIORITY_HIGH)
+				byte_read = _read_byte_from_priority_buffer(&next_byte);
+			else if (_tx_frame_priority == ASK_TRANSMITTER_PRIORITY_SCHEDULED)
+				byte_read = _read_byte_from_scheduled_buffer(&next_byte);
+			else
+				byte_read = _read_byte_from_buffer(&next_byte);
+			if (!byte_read)
+				return false;
+		}
+		if (_flags & ASK_TRANSMITTER_FLAG_SCRAMBLED_NRZ)
+		{
+			_tx_output_word = (uint16_t)(next_byte ^ ask_scrambler_sequence(&_tx_scrambler_state));
+			_tx_output_bit_count = 8;
+		}
+		else
+		{
+			_tx_output_word = _encode_byte(next_byte);
+			_tx_output_bit_count = 12;
+		}
+	}
+	_tx_frame_word_index = word_index + 1;
+	return true;
 }
 
 void ask_transmitter_t::_write_byte_to_buffer(uint8_t data)
@@ -328,4 +541,216 @@ bool ask_transmitter_t::_read_byte_from_buffer(uint8_t* data)
 		return true;
 	}
 	return false;
+}
+
+size_t ask_transmitter_t::_get_priority_buffer_free_space()
+{
+	size_t maximum_write_index = _tx_priority_buffer_read_index;
+	size_t write_index = _tx_priority_buffer_write_index;
+	if (maximum_write_index)
+		--maximum_write_index;
+	else
+		maximum_write_index = ASK_TRANSMITTER_PRIORITY_BUFFER_SIZE - 1;
+	if (maximum_write_index < write_index)
+		return ASK_TRANSMITTER_PRIORITY_BUFFER_SIZE - write_index + maximum_write_index;
+	else
+		return maximum_write_index - write_index;
+}
+
+void ask_transmitter_t::_write_byte_to_priority_buffer(size_t* write_index, uint8_t data)
+{
+	// the function assumes that threre is free space in the buffer
+	// written bytes become readable when the write index of the buffer is updated
+	size_t index = *write_index;
+	_tx_priority_buffer[index++] = data;
+	if (index != ASK_TRANSMITTER_PRIORITY_BUFFER_SIZE)
+		*write_index = index;
+	else
+		*write_index = 0;
+}
+
+bool ask_transmitter_t::_read_byte_from_priority_buffer(uint8_t* data)
+{
+	// read next available byte from the priority buffer if there is any available bytes
+	size_t read_index = _tx_priority_buffer_read_index;
+	if (read_index != _tx_priority_buffer_write_index)
+	{
+		*data = _tx_priority_buffer[read_index++];
+		if (read_index != ASK_TRANSMITTER_PRIORITY_BUFFER_SIZE)
+			_tx_priority_buffer_read_index = read_index;
+		else
+			_tx_priority_buffer_read_index = 0;
+		return true;
+	}
+	return false;
+}
+
+size_t ask_transmitter_t::_get_scheduled_buffer_free_space()
+{
+	size_t maximum_write_index = _tx_scheduled_buffer_read_index;
+	size_t write_index = _tx_scheduled_buffer_write_index;
+	if (maximum_write_index)
+		--maximum_write_index;
+	else
+		maximum_write_index = ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE - 1;
+	if (maximum_write_index < write_index)
+		return ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE - write_index + maximum_write_index;
+	else
+		return maximum_write_index - write_index;
+}
+
+void ask_transmitter_t::_write_byte_to_scheduled_buffer(size_t* write_index, uint8_t data)
+{
+	// the function assumes that threre is free space in the buffer
+	// written bytes become readable when the write index of the buffer is updated
+	size_t index = *write_index;
+	_tx_scheduled_buffer[index++] = data;
+	if (index != ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE)
+		*write_index = index;
+	else
+		*write_index = 0;
+}
+
+bool ask_transmitter_t::_read_byte_from_scheduled_buffer(uint8_t* data)
+{
+	// read next available byte from the scheduled buffer if there is any available bytes
+	size_t read_index = _tx_scheduled_buffer_read_index;
+	if (read_index != _tx_scheduled_buffer_write_index)
+	{
+		*data = _tx_scheduled_buffer[read_index++];
+		if (read_index != ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE)
+			_tx_scheduled_buffer_read_index = read_index;
+		else
+			_tx_scheduled_buffer_read_index = 0;
+		return true;
+	}
+	return false;
+}
+
+uint8_t ask_transmitter_t::_peek_byte_from_scheduled_buffer(size_t offset)
+{
+	// the function assumes that there is atleast offset + 1 bytes available in the buffer
+	return _tx_scheduled_buffer[(_tx_scheduled_buffer_read_index + offset) % ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE];
+}
+
+void ask_transmitter_t::_write_packet_byte(int priority, size_t* packet_write_index, uint8_t data)
+{
+	if (priority == ASK_TRANSMITTER_PRIORITY_HIGH)
+		_write_byte_to_priority_buffer(packet_write_index, data);
+	else if (priority == ASK_TRANSMITTER_PRIORITY_SCHEDULED)
+		_write_byte_to_scheduled_buffer(packet_write_index, data);
+	else
+		_write_byte_to_buffer(data);
+}
+
+bool ask_transmitter_t::_write_packet(uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const ask_transmitter_buffer_t* buffers, size_t buffer_count, int priority, uint32_t timestamp)
+{
+	if (!_is_initialized)
+		return false;
+
+	// calculate total length of the message
+	size_t message_byte_length = 0;
+	for (size_t i = 0; i != buffer_count; ++i)
+	{
+		if (buffers[i].length > ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE)
+			return false;
+		message_byte_length += buffers[i].length;
+	}
+
+	// with forward error correction parity is append after the crc and two copies of the length follow the length, they reduce the maximum message size
+	size_t parity_size = (_flags & ASK_TRANSMITTER_FLAG_FEC) ? ASK_FEC_PARITY_SIZE : 0;
+	size_t length_copy_size = (_flags & ASK_TRANSMITTER_FLAG_FEC) ? 2 : 0;
+	size_t maximum_message_byte_length = ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE;
+	if (priority == ASK_TRANSMITTER_PRIORITY_HIGH)
+		maximum_message_byte_length = ASK_TRANSMITTER_MAXIMUM_PRIORITY_MESSAGE_SIZE;
+	else if (priority == ASK_TRANSMITTER_PRIORITY_SCHEDULED)
+		maximum_message_byte_length = ASK_TRANSMITTER_MAXIMUM_SCHEDULED_MESSAGE_SIZE;
+	if (message_byte_length + parity_size + length_copy_size > maximum_message_byte_length)
+		return false;
+
+	// the packet begins with length of the packet, header rx address, header tx address, header id, header flags
+	// lenght of the packet is (1 byte lenght + 1 byte rx address + 1 byte tx ddress + 1 byte id + 1 byte flags + n bytes message + 2 bytes crc + parity bytes)
+	// the interrupt handler reads the length from the buffer and sends preamble and start symbol before the packet
+	uint8_t length_and_header[5] = { (uint8_t)(7 + message_byte_length + parity_size), rx_address, tx_address, header_id, header_flags, };
+
+	// high priority and scheduled packets are written to their buffers after there is space for whole packet
+	// in the scheduled buffer the packet begins with time stamp before the length
+	size_t packet_write_index = 0;
+	if (priority == ASK_TRANSMITTER_PRIORITY_HIGH)
+	{
+		while (_get_priority_buffer_free_space() < 7 + message_byte_length + parity_size + length_copy_size)
+			continue;
+		packet_write_index = _tx_priority_buffer_write_index;
+	}
+	else if (priority == ASK_TRANSMITTER_PRIORITY_SCHEDULED)
+	{
+		while (_get_scheduled_buffer_free_space() < ASK_TRANSMITTER_SCHEDULED_PACKET_SIZE(message_byte_length + parity_size + length_copy_size))
+			continue;
+		packet_write_index = _tx_scheduled_buffer_write_index;
+		for (int i = 0; i != 4; ++i)
+			_write_byte_to_scheduled_buffer(&packet_write_index, (uint8_t)(timestamp >> (i << 3)));
+	}
+
+	// crc init is 0xFFFF
+	uint16_t crc = 0xFFFF;
+
+	// parity covers every byte of the packet after the length
+	uint8_t parity[ASK_FEC_PARITY_SIZE];
+	ask_fec_encode_init(parity);
+
+	uint8_t next_byte;
+
+	// write length and header to output buffer
+	// the length is not covered by the parity, so with forward error correction it is send three times and the copies count the two extra bytes
+	// crc is calculated over the length without the extra bytes like for packets with single length byte
+	for (size_t i = 0; i != sizeof(length_and_header); ++i)
+	{
+		next_byte = length_and_header[i];
+		crc = _kermit.fastCRC(crc, next_byte);
+		if (parity_size && i)
+			ask_fec_encode_byte(parity, next_byte);
+		if (!i && length_copy_size)
+			for (size_t j = 0; j != length_copy_size + 1; ++j)
+				_write_packet_byte(priority, &packet_write_index, (uint8_t)(next_byte + length_copy_size));
+		else
+			_write_packet_byte(priority, &packet_write_index, next_byte);
+	}
+
+	// write message data from all buffers to output buffer
+	for (size_t i = 0; i != buffer_count; ++i)
+		for (const uint8_t* data = (const uint8_t*)buffers[i].data, *data_end = data + buffers[i].length; data != data_end; ++data)
+		{
+			next_byte = *data;
+			crc = _kermit.fastCRC(crc, next_byte);
+			if (parity_size)
+				ask_fec_encode_byte(parity, next_byte);
+			_write_packet_byte(priority, &packet_write_index, next_byte);
+		}
+
+	// crc xorout is 0xFFFF
+	crc ^= 0xFFFF;
+
+	// write crc to output buffer in little endian byte order
+	_write_packet_byte(priority, &packet_write_index, (uint8_t)(crc & 0xFF));
+	_write_packet_byte(priority, &packet_write_index, (uint8_t)(crc >> 8));
+
+	// write parity of the packet to output buffer
+	if (parity_size)
+	{
+		ask_fec_encode_byte(parity, (uint8_t)(crc & 0xFF));
+		ask_fec_encode_byte(parity, (uint8_t)(crc >> 8));
+		for (size_t i = 0; i != ASK_FEC_PARITY_SIZE; ++i)
+			_write_packet_byte(priority, &packet_write_index, parity[i]);
+	}
+
+	// make whole high priority or scheduled packet readable to the interrupt handler
+	if (priority == ASK_TRANSMITTER_PRIORITY_HIGH)
+		_tx_priority_buffer_write_index = packet_write_index;
+	else if (priority == ASK_TRANSMITTER_PRIORITY_SCHEDULED)
+		_tx_scheduled_buffer_write_index = packet_write_index;
+
+	++_packets_send;
+	_bytes_send += message_byte_length;
+
+	return true;
 }
\ No newline at end of file
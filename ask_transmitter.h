@@ -1,5 +1,5 @@
 /*
-	Mbed OS ASK transmitter version version 1.3.2 2018-08-01 by Santtu Nyman.
+	Mbed OS ASK transmitter version version 1.14.2 2026-10-19 by Santtu Nyman.
 	This file is part of mbed-os-ask "https://github.com/Santtu-Nyman/mbed-os-ask".
 
 	Description
@@ -7,6 +7,32 @@
 		The transmitter can be used to communicate with RadioHead library.
 
 	Version history
+		version 1.14.2 2026-10-19
+			Interrupt handler checks reads from all packet buffers.
+		version 1.14.1 2026-10-19
+			Scrambler moved to ask_scrambler.h, that is shared with the receiver.
+		version 1.14.0 2026-10-19
+			Length of packets with forward error correction is send three times.
+		version 1.13.0 2026-10-19
+			Scheduled packets have their own buffer and they are not limited by the priority buffer.
+		version 1.12.0 2026-10-19
+			Overloads of send, sendv, send_at and sendv_at with header id and flags added.
+		version 1.11.0 2026-10-19
+			Scrambled NRZ line code flag added.
+		version 1.10.0 2026-10-19
+			Forward error correction flag added.
+		version 1.9.0 2026-10-19
+			Added new overload for init and constructor with transmitter flags and burst mode.
+		version 1.8.0 2026-10-19
+			Scheduled packets added.
+		version 1.7.0 2026-10-19
+			High priority packets added.
+		version 1.6.0 2026-10-19
+			sendv member function added.
+		version 1.5.0 2026-10-19
+			render member function added.
+		version 1.4.0 2026-10-19
+			Transmitter buffer stores raw frame bytes that are encoded by the interrupt handler.
 		version 1.3.2 2018-08-01
 			Wired debug mode added.
 		version 1.3.1 2018-07-13
@@ -49,27 +75,59 @@
 #define ASK_TRANSMITTER_H
 
 #define ASK_TRANSMITTER_VERSION_MAJOR 1
-#define ASK_TRANSMITTER_VERSION_MINOR 3
+#define ASK_TRANSMITTER_VERSION_MINOR 14
 #define ASK_TRANSMITTER_VERSION_PATCH 2
 
 #define ASK_TRANSMITTER_IS_VERSION_ATLEAST(h, m, l) ((((unsigned long)(h) << 16) | ((unsigned long)(m) << 8) | (unsigned long)(l)) <= ((ASK_TRANSMITTER_VERSION_MAJOR << 16) | (ASK_TRANSMITTER_VERSION_MINOR << 8) | ASK_TRANSMITTER_VERSION_PATCH))
 
 #include "mbed.h"
 #include "ask_CRC16.h"
+#include "ask_fec.h"
+#include "ask_scrambler.h"
 #include <stddef.h>
 #include <stdint.h>
 
 #ifndef ASK_TRANSMITTER_BUFFER_SIZE
 #define ASK_TRANSMITTER_BUFFER_SIZE 64
 #endif
+#ifndef ASK_TRANSMITTER_PRIORITY_BUFFER_SIZE
+#define ASK_TRANSMITTER_PRIORITY_BUFFER_SIZE 64
+#endif
+#ifndef ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE
+#define ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE 512
+#endif
 #define ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE 0xF8
+#define ASK_TRANSMITTER_MAXIMUM_PRIORITY_MESSAGE_SIZE (ASK_TRANSMITTER_PRIORITY_BUFFER_SIZE - 8)
+#define ASK_TRANSMITTER_MAXIMUM_SCHEDULED_MESSAGE_SIZE ((ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE - 12 < ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE) ? (ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE - 12) : ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE)
+#define ASK_TRANSMITTER_MAXIMUM_FEC_MESSAGE_SIZE (ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE - ASK_FEC_PARITY_SIZE - 2)
 #define ASK_TRANSMITTER_BROADCAST_ADDRESS 0xFF
 
+#define ASK_TRANSMITTER_PRIORITY_NORMAL 0
+#define ASK_TRANSMITTER_PRIORITY_HIGH 1
+
+#define ASK_TRANSMITTER_FLAG_BURST_MODE 0x1
+#define ASK_TRANSMITTER_FLAG_FEC 0x2
+#define ASK_TRANSMITTER_FLAG_SCRAMBLED_NRZ 0x4
+#define ASK_TRANSMITTER_VALID_FLAGS (ASK_TRANSMITTER_FLAG_BURST_MODE | ASK_TRANSMITTER_FLAG_FEC | ASK_TRANSMITTER_FLAG_SCRAMBLED_NRZ)
+
+// space used in the scheduled buffer by a scheduled packet with message of given size. 4 bytes time stamp and the packet, message size includes the parity and the two length copies when forward error correction is used
+#define ASK_TRANSMITTER_SCHEDULED_PACKET_SIZE(message_byte_length) (4 + 7 + (size_t)(message_byte_length))
+
+// size of buffer required to render a packet with message of given size. preamble and start symbol 48 bits, 12 bits per packet byte and 6 low bits after the packet
+#define ASK_TRANSMITTER_RENDER_BUFFER_SIZE(message_byte_length) ((48 + (7 + (size_t)(message_byte_length)) * 12 + 6 + 7) / 8)
+
+typedef struct ask_transmitter_buffer_t
+{
+	const void* data;
+	size_t length;
+} ask_transmitter_buffer_t;
+
 typedef struct ask_transmitter_status_t
 {
 	int tx_frequency;
 	PinName tx_pin;
 	uint8_t tx_address;
+	uint32_t flags;
 	bool initialized;
 	bool active;
 	size_t packets_send;
@@ -83,6 +141,7 @@ class ask_transmitter_t
 		
 		ask_transmitter_t(int tx_frequency, PinName tx_pin);
 		ask_transmitter_t(int tx_frequency, PinName tx_pin, uint8_t new_tx_address);
+		ask_transmitter_t(int tx_frequency, PinName tx_pin, uint8_t new_tx_address, uint32_t flags);
 		// These constructors call init with same parameters.
 		
 		~ask_transmitter_t();
@@ -129,6 +188,44 @@ class ask_transmitter_t
 				If the function succeeds, the return value is true and false on failure.
 		*/
 		
+		bool init(int tx_frequency, PinName tx_pin, uint8_t new_tx_address, uint32_t flags);
+		/*
+			Description
+				Initializes the transmitter object with given parameters. If the transmitter is already initialized it is reinitialized with the new parameters.
+				This function fails if an initialized transmitter already exists.
+				Value of tx_address is set to the new tx address.
+			Parameters
+				tx_frequency
+					The frequency of the transmitter. This value is required to be valid frequency or 0, or the function fails.
+					Valid frequencies are 1000, 1250, 2500 and 3125.
+					If this parameter is 0 and the transmitter is initialized it will shutdown.
+					If this parameter is 0 and the transmitter is not initialized it will not be initialized.
+					The transmitter is not initialized after it is shutdown.
+				tx_pin
+					Mbed OS pin name for tx pin.
+				new_tx_address
+					tx address for the transmitter.
+				flags
+					Combination of transmitter flags or 0. Other initialization functions set the flags to 0.
+					ASK_TRANSMITTER_FLAG_BURST_MODE
+						Packets that are ready to be send when the previous packet ends are send after it in a burst.
+						Packets after the first packet of the burst are preceded only by the start symbol, not by the preamble and the low bits after the previous packet.
+						Receiver needs ASK_RECEIVER_FLAG_BURST_MODE to reliably receive the bursts.
+					ASK_TRANSMITTER_FLAG_FEC
+						ASK_FEC_PARITY_SIZE bytes of Reed-Solomon parity are appended after the crc of every packet and the length of the packet includes them.
+						The parity is calculated over the packet after the length byte and it allows receiver to correct up to ASK_FEC_PARITY_SIZE / 2 erroneous bytes.
+						The length byte is not covered by the parity, so it is send three times and the receiver corrects it by majority of every bit. The copies count the two extra bytes.
+						Maximum message sizes are reduced by ASK_FEC_PARITY_SIZE + 2 bytes.
+						Receiver needs ASK_RECEIVER_FLAG_FEC to receive these packets and these packets are not compatible with RadioHead library.
+					ASK_TRANSMITTER_FLAG_SCRAMBLED_NRZ
+						Bytes of the packet after the start symbol are send as 8 bits instead of two 4b6b symbols, which reduces the airtime of the packet bytes by a third.
+						The bytes are scrambled by 7-bit additive scrambler x^7 + x^4 + 1 that is reset at the start of every packet to keep the signal changing.
+						Preamble, start symbol and the low bits after the packet are not changed.
+						Receiver needs ASK_RECEIVER_FLAG_SCRAMBLED_NRZ to receive these packets and these packets are not compatible with RadioHead library.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+		
 		bool send(uint8_t rx_address, const void* message_data, size_t message_byte_length);
 		/*
 			Description
@@ -164,6 +261,224 @@ class ask_transmitter_t
 				If the function succeeds, the return value is true and false on failure.
 		*/
 
+		bool sendv(uint8_t rx_address, const ask_transmitter_buffer_t* buffers, size_t buffer_count);
+		/*
+			Description
+				Writes packet with message gathered from given buffers to the buffer of the transmitter, which is then sent by the interrupt handler.
+				The message is the data of all the buffers in the order they are given, so header and payload can be in separate buffers without copying them together.
+				This function will block, if not enough space for the packet in buffer.
+				The transmitter is required to be initialized or this function will fail.
+			Parameters
+				rx_address
+					Address of the receiver.
+				buffers
+					Pointer to array of buffers that contain the message.
+				buffer_count
+					The number of buffers in the array pointed by buffers.
+					Total length of the buffers is the number of bytes to be send and the maximum value for it is ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
+		bool send(uint8_t rx_address, const void* message_data, size_t message_byte_length, int priority);
+		/*
+			Description
+				Writes packet with given message and priority to the buffer of the transmitter, which is then sent by the interrupt handler.
+				High priority packets are written to separate buffer and they become available to the interrupt handler only when the whole packet is written.
+				When the interrupt handler finishes sending a packet, it sends next high priority packet before any normal priority packets.
+				Packet that is being send is never interrupted.
+				This function will block, if not enough space for the packet in buffer.
+				The transmitter is required to be initialized or this function will fail.
+			Parameters
+				rx_address
+					Address of the receiver.
+				message_data
+					Pointer to the data to by send.
+				message_byte_length
+					The number of bytes to be send.
+					maximum value for this parameter is ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE for normal priority and ASK_TRANSMITTER_MAXIMUM_PRIORITY_MESSAGE_SIZE for high priority.
+				priority
+					Priority of the packet. This value is required to be ASK_TRANSMITTER_PRIORITY_NORMAL or ASK_TRANSMITTER_PRIORITY_HIGH.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
+		bool sendv(uint8_t rx_address, const ask_transmitter_buffer_t* buffers, size_t buffer_count, int priority);
+		/*
+			Description
+				Writes packet with message gathered from given buffers and given priority to the buffer of the transmitter, which is then sent by the interrupt handler.
+				The message is the data of all the buffers in the order they are given.
+				High priority packets are written to separate buffer and they become available to the interrupt handler only when the whole packet is written.
+				When the interrupt handler finishes sending a packet, it sends next high priority packet before any normal priority packets.
+				Packet that is being send is never interrupted.
+				This function will block, if not enough space for the packet in buffer.
+				The transmitter is required to be initialized or this function will fail.
+			Parameters
+				rx_address
+					Address of the receiver.
+				buffers
+					Pointer to array of buffers that contain the message.
+				buffer_count
+					The number of buffers in the array pointed by buffers.
+					Total length of the buffers is the number of bytes to be send.
+					Maximum value for it is ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE for normal priority and ASK_TRANSMITTER_MAXIMUM_PRIORITY_MESSAGE_SIZE for high priority.
+				priority
+					Priority of the packet. This value is required to be ASK_TRANSMITTER_PRIORITY_NORMAL or ASK_TRANSMITTER_PRIORITY_HIGH.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
+		bool send_at(uint32_t timestamp, uint8_t rx_address, const void* message_data, size_t message_byte_length);
+		/*
+			Description
+				Writes packet with given message to the scheduled packet buffer of the transmitter, which is then sent by the interrupt handler at given time.
+				The interrupt handler holds the packet until the time is reached and begins sending the preamble at the first bit period after it.
+				Scheduled packets are send in the order they are written to the scheduled packet buffer.
+				High and normal priority packets are send before the scheduled packet only if they are completely send before the scheduled time.
+				If the time has already passed the packet is send as soon as possible.
+				Each packet uses ASK_TRANSMITTER_SCHEDULED_PACKET_SIZE(message_byte_length) bytes of the ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE byte buffer until it is send.
+				This function does not wait for the time, it will block only if not enough space for the packet in buffer.
+				The transmitter is required to be initialized or this function will fail.
+			Parameters
+				timestamp
+					Time when the packet is send. The time is value of us_ticker_read in microseconds and it is required to be less than 2^31 microseconds in the future.
+				rx_address
+					Address of the receiver.
+				message_data
+					Pointer to the data to by send.
+				message_byte_length
+					The number of bytes to be send.
+					maximum value for this parameter is ASK_TRANSMITTER_MAXIMUM_SCHEDULED_MESSAGE_SIZE.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
+		bool sendv_at(uint32_t timestamp, uint8_t rx_address, const ask_transmitter_buffer_t* buffers, size_t buffer_count);
+		/*
+			Description
+				Writes packet with message gathered from given buffers to the scheduled packet buffer of the transmitter, which is then sent by the interrupt handler at given time.
+				The message is the data of all the buffers in the order they are given.
+				The packet is scheduled like packets of send_at.
+				This function does not wait for the time, it will block only if not enough space for the packet in buffer.
+				The transmitter is required to be initialized or this function will fail.
+			Parameters
+				timestamp
+					Time when the packet is send. The time is value of us_ticker_read in microseconds and it is required to be less than 2^31 microseconds in the future.
+				rx_address
+					Address of the receiver.
+				buffers
+					Pointer to array of buffers that contain the message.
+				buffer_count
+					The number of buffers in the array pointed by buffers.
+					Total length of the buffers is the number of bytes to be send and the maximum value for it is ASK_TRANSMITTER_MAXIMUM_SCHEDULED_MESSAGE_SIZE.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
+		bool send(uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const void* message_data, size_t message_byte_length, int priority);
+		/*
+			Description
+				Writes packet with given header id, header flags, message and priority to the buffer of the transmitter, which is then sent by the interrupt handler.
+				Other send functions set the header id and the header flags to 0.
+				Receivers with ASK_RECEIVER_FLAG_DUPLICATE_FILTER drop packets that have same tx address and non-zero header id as the previous packet from the same transmitter.
+				This function will block, if not enough space for the packet in buffer.
+				The transmitter is required to be initialized or this function will fail.
+			Parameters
+				rx_address
+					Address of the receiver.
+				header_id
+					Value of RadioHead header id. Value 0 means that the packet has no id.
+				header_flags
+					Value of RadioHead header flags.
+				message_data
+					Pointer to the data to by send.
+				message_byte_length
+					The number of bytes to be send.
+					maximum value for this parameter is ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE for normal priority and ASK_TRANSMITTER_MAXIMUM_PRIORITY_MESSAGE_SIZE for high priority.
+				priority
+					Priority of the packet. This value is required to be ASK_TRANSMITTER_PRIORITY_NORMAL or ASK_TRANSMITTER_PRIORITY_HIGH.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
+		bool sendv(uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const ask_transmitter_buffer_t* buffers, size_t buffer_count, int priority);
+		/*
+			Description
+				Writes packet with given header id, header flags, message gathered from given buffers and given priority to the buffer of the transmitter, which is then sent by the interrupt handler.
+				The message is the data of all the buffers in the order they are given.
+				Other send functions set the header id and the header flags to 0.
+				This function will block, if not enough space for the packet in buffer.
+				The transmitter is required to be initialized or this function will fail.
+			Parameters
+				rx_address
+					Address of the receiver.
+				header_id
+					Value of RadioHead header id. Value 0 means that the packet has no id.
+				header_flags
+					Value of RadioHead header flags.
+				buffers
+					Pointer to array of buffers that contain the message.
+				buffer_count
+					The number of buffers in the array pointed by buffers.
+					Total length of the buffers is the number of bytes to be send.
+					Maximum value for it is ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE for normal priority and ASK_TRANSMITTER_MAXIMUM_PRIORITY_MESSAGE_SIZE for high priority.
+				priority
+					Priority of the packet. This value is required to be ASK_TRANSMITTER_PRIORITY_NORMAL or ASK_TRANSMITTER_PRIORITY_HIGH.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
+		bool send_at(uint32_t timestamp, uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const void* message_data, size_t message_byte_length);
+		/*
+			Description
+				Writes packet with given header id, header flags and message to the scheduled packet buffer of the transmitter, which is then sent by the interrupt handler at given time.
+				The packet is scheduled like packets of send_at without header id and flags.
+				This function does not wait for the time, it will block only if not enough space for the packet in buffer.
+				The transmitter is required to be initialized or this function will fail.
+			Parameters
+				timestamp
+					Time when the packet is send. The time is value of us_ticker_read in microseconds and it is required to be less than 2^31 microseconds in the future.
+				rx_address
+					Address of the receiver.
+				header_id
+					Value of RadioHead header id. Value 0 means that the packet has no id.
+				header_flags
+					Value of RadioHead header flags.
+				message_data
+					Pointer to the data to by send.
+				message_byte_length
+					The number of bytes to be send.
+					maximum value for this parameter is ASK_TRANSMITTER_MAXIMUM_SCHEDULED_MESSAGE_SIZE.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
+		bool sendv_at(uint32_t timestamp, uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const ask_transmitter_buffer_t* buffers, size_t buffer_count);
+		/*
+			Description
+				Writes packet with given header id, header flags and message gathered from given buffers to the scheduled packet buffer of the transmitter, which is then sent by the interrupt handler at given time.
+				The message is the data of all the buffers in the order they are given.
+				The packet is scheduled like packets of send_at without header id and flags.
+				This function does not wait for the time, it will block only if not enough space for the packet in buffer.
+				The transmitter is required to be initialized or this function will fail.
+			Parameters
+				timestamp
+					Time when the packet is send. The time is value of us_ticker_read in microseconds and it is required to be less than 2^31 microseconds in the future.
+				rx_address
+					Address of the receiver.
+				header_id
+					Value of RadioHead header id. Value 0 means that the packet has no id.
+				header_flags
+					Value of RadioHead header flags.
+				buffers
+					Pointer to array of buffers that contain the message.
+				buffer_count
+					The number of buffers in the array pointed by buffers.
+					Total length of the buffers is the number of bytes to be send and the maximum value for it is ASK_TRANSMITTER_MAXIMUM_SCHEDULED_MESSAGE_SIZE.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
 		void status(ask_transmitter_status_t* current_status);
 		/*
 			Description
@@ -175,6 +490,34 @@ class ask_transmitter_t
 				No return value.
 		*/
 
+		static size_t render(uint8_t rx_address, uint8_t tx_address, const void* message_data, size_t message_byte_length, void* bit_buffer, size_t bit_buffer_size);
+		/*
+			Description
+				Renders packet with given message to a buffer as packed bitstream.
+				The bitstream contains preamble, start symbol, the encoded packet and the low bits after the packet, exactly as they are send by the interrupt handler.
+				Bits are stored in the order they are send starting from the most significant bit of the first byte, one bit per bit period.
+				This allows the packet to be send by some other peripheral like SPI, that clocks the bitstream out at the bit rate.
+				This function does not require initialized transmitter.
+			Parameters
+				rx_address
+					Address of the receiver.
+				tx_address
+					Address of the transmitter.
+				message_data
+					Pointer to the data to by send.
+				message_byte_length
+					The number of bytes to be send.
+					maximum value for this parameter is ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE.
+				bit_buffer
+					Pointer to buffer that receives the bitstream.
+					Unused bits of the last byte are set to 0.
+				bit_buffer_size
+					Size of the buffer pointed by bit_buffer in bytes.
+					The size required for the packet is ASK_TRANSMITTER_RENDER_BUFFER_SIZE(message_byte_length).
+			Return
+				If the function succeeds, the return value is number of bits rendered and 0 on failure.
+		*/
+
 		static bool is_valid_frequency(int frequency);
 		/*
 			Description
@@ -193,27 +536,49 @@ class ask_transmitter_t
 
 	private :
 		static void _tx_interrupt_handler();
-		static uint8_t _high_nibble(uint8_t byte);
-		static uint8_t _low_nibble(uint8_t byte);
-		static uint8_t _encode_symbol(uint8_t _4bit_data);
+		static uint16_t _encode_byte(uint8_t byte);
+		static void _write_bits_to_bitstream(uint8_t* bitstream, size_t* bit_index, uint16_t bits, uint8_t bit_count);
+		bool _begin_next_packet();
+		bool _load_next_output_word();
 		
 		void _write_byte_to_buffer(uint8_t data);
 		bool _read_byte_from_buffer(uint8_t* data);
+		size_t _get_priority_buffer_free_space();
+		void _write_byte_to_priority_buffer(size_t* write_index, uint8_t data);
+		bool _read_byte_from_priority_buffer(uint8_t* data);
+		size_t _get_scheduled_buffer_free_space();
+		void _write_byte_to_scheduled_buffer(size_t* write_index, uint8_t data);
+		bool _read_byte_from_scheduled_buffer(uint8_t* data);
+		uint8_t _peek_byte_from_scheduled_buffer(size_t offset);
+		void _write_packet_byte(int priority, size_t* packet_write_index, uint8_t data);
+		bool _write_packet(uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const ask_transmitter_buffer_t* buffers, size_t buffer_count, int priority, uint32_t timestamp);
 
 		bool _is_initialized;
 		CRC16 _kermit;
 		gpio_t _tx_pin;
 		size_t _packets_send;
 		size_t _bytes_send;
-		uint8_t _tx_output_symbol;
-		volatile uint8_t _tx_output_symbol_bit_index;
+		uint16_t _tx_output_word;
+		volatile uint8_t _tx_output_bit_count;
+		volatile uint8_t _tx_frame_length;
+		uint16_t _tx_frame_word_index;
+		int _tx_frame_priority;
+		uint8_t _tx_scrambler_state;
 		volatile size_t _tx_buffer_read_index;
 		volatile size_t _tx_buffer_write_index;
 		volatile uint8_t _tx_buffer[ASK_TRANSMITTER_BUFFER_SIZE];
+		volatile size_t _tx_priority_buffer_read_index;
+		volatile size_t _tx_priority_buffer_write_index;
+		volatile uint8_t _tx_priority_buffer[ASK_TRANSMITTER_PRIORITY_BUFFER_SIZE];
+		volatile size_t _tx_scheduled_buffer_read_index;
+		volatile size_t _tx_scheduled_buffer_write_index;
+		volatile uint8_t _tx_scheduled_buffer[ASK_TRANSMITTER_SCHEDULED_BUFFER_SIZE];
 		Ticker _tx_timer;
 
 		// transmitter initialization parameters
+		uint32_t _flags;
 		int _tx_frequency;
+		int _us_per_bit;
 		PinName _tx_pin_name;
 
 		// No copying object of this type!
@@ -0,0 +1,87 @@
+// Host benchmark of goodput against bit error rate with and without forward error correction.
+// Packets are send through the simulated radio, that flips every bit period with the given probability.
+// Goodput is the bits of correctly received messages per second of airtime at 1000 bit/s.
+// Build and run with "run_tests.sh ask_fec_benchmark", it is not run by default.
+
+#include "mbed.h"
+#include "ask_transmitter.h"
+#include "ask_receiver.h"
+#include <stdlib.h>
+
+#define BENCHMARK_PACKET_COUNT 200
+
+// only one transmitter and one receiver object can be initialized during the program, so they are reinitialized for every test
+static ask_transmitter_t transmitter;
+static ask_receiver_t receiver;
+
+static double bit_error_rate;
+static uint64_t noise_bit = ~(uint64_t)0;
+static int noise_flip;
+
+static int noise()
+{
+	// the noise flips whole bit periods
+	uint64_t bit = sim_time_ns / 1000000;
+	if (bit != noise_bit)
+	{
+		noise_bit = bit;
+		noise_flip = (rand() / (RAND_MAX + 1.0)) < bit_error_rate;
+	}
+	return noise_flip;
+}
+
+static double benchmark(uint32_t transmitter_flags, uint32_t receiver_flags, size_t message_size)
+{
+	transmitter.init(1000, D2, 0x11, transmitter_flags);
+	receiver.init(1000, D3, 0x22, false, receiver_flags);
+	int bits_per_byte = (transmitter_flags & ASK_TRANSMITTER_FLAG_SCRAMBLED_NRZ) ? 8 : 12;
+	size_t packet_size = 7 + message_size + ((transmitter_flags & ASK_TRANSMITTER_FLAG_FEC) ? ASK_FEC_PARITY_SIZE + 2 : 0);
+	uint64_t packet_bits = 48 + packet_size * (size_t)bits_per_byte + 6;
+	size_t delivered_bits = 0;
+	uint8_t message[ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE];
+	uint8_t received[ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE];
+	for (int i = 0; i != BENCHMARK_PACKET_COUNT; ++i)
+	{
+		for (size_t j = 0; j != message_size; ++j)
+			message[j] = (uint8_t)rand();
+		transmitter.send(0x22, message, message_size);
+		sim_advance_us((packet_bits + 32) * 1000);
+		if (receiver.recv(received, sizeof(received)) == message_size && !memcmp(received, message, message_size))
+			delivered_bits += message_size * 8;
+	}
+	return (double)delivered_bits / ((double)(BENCHMARK_PACKET_COUNT * packet_bits) / 1000.0);
+}
+
+int main()
+{
+	static const double bit_error_rates[] = { 0.0, 0.001, 0.002, 0.005, 0.01, 0.02 };
+	static const size_t message_sizes[] = { 16, 64, 200 };
+	static const struct { const char* name; uint32_t transmitter_flags; uint32_t receiver_flags; } modes[] = {
+		{ "4b6b", 0, 0 },
+		{ "4b6b FEC", ASK_TRANSMITTER_FLAG_FEC, ASK_RECEIVER_FLAG_FEC },
+		{ "NRZ", ASK_TRANSMITTER_FLAG_SCRAMBLED_NRZ, ASK_RECEIVER_FLAG_SCRAMBLED_NRZ },
+		{ "NRZ FEC", ASK_TRANSMITTER_FLAG_SCRAMBLED_NRZ | ASK_TRANSMITTER_FLAG_FEC, ASK_RECEIVER_FLAG_SCRAMBLED_NRZ | ASK_RECEIVER_FLAG_FEC } };
+
+	sim_noise = noise;
+	printf("goodput bit/s at 1000 bit/s, %i packets per point\n", BENCHMARK_PACKET_COUNT);
+	for (size_t s = 0; s != sizeof(message_sizes) / sizeof(size_t); ++s)
+	{
+		printf("\n%3u byte messages  BER:", (unsigned int)message_sizes[s]);
+		for (size_t b = 0; b != sizeof(bit_error_rates) / sizeof(double); ++b)
+			printf(" %7.3f", bit_error_rates[b]);
+		printf("\n");
+		for (size_t m = 0; m != sizeof(modes) / sizeof(modes[0]); ++m)
+		{
+			printf("%-24s", modes[m].name);
+			for (size_t b = 0; b != sizeof(bit_error_rates) / sizeof(double); ++b)
+			{
+				bit_error_rate = bit_error_rates[b];
+				srand(7);
+				printf(" %7.1f", benchmark(modes[m].transmitter_flags, modes[m].receiver_flags, message_sizes[s]));
+				fflush(stdout);
+			}
+			printf("\n");
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,118 @@
+// Host test of the Reed-Solomon code of ask_fec and of packets with forward error correction.
+// Blocks of every size are encoded and corrupted by up to ASK_FEC_PARITY_SIZE / 2 erroneous bytes that ask_fec_decode needs to correct.
+// Packets with forward error correction are send through the simulated radio with one copy of the length corrupted and some corrupted bytes.
+// Build and run with run_tests.sh.
+
+#include "mbed.h"
+#include "ask_fec.h"
+#include "ask_transmitter.h"
+#include "ask_receiver.h"
+#include <stdlib.h>
+
+static int failures;
+
+// only one transmitter and one receiver object can be initialized during the program, so they are reinitialized for every test
+static ask_transmitter_t transmitter;
+static ask_receiver_t receiver;
+
+static void test_block(size_t block_size, int error_count)
+{
+	uint8_t block[ASK_FEC_MAXIMUM_BLOCK_SIZE];
+	uint8_t original[ASK_FEC_MAXIMUM_BLOCK_SIZE];
+	uint8_t parity[ASK_FEC_PARITY_SIZE];
+	size_t data_size = block_size - ASK_FEC_PARITY_SIZE;
+
+	ask_fec_encode_init(parity);
+	for (size_t i = 0; i != data_size; ++i)
+	{
+		block[i] = (uint8_t)rand();
+		ask_fec_encode_byte(parity, block[i]);
+	}
+	memcpy(block + data_size, parity, ASK_FEC_PARITY_SIZE);
+	memcpy(original, block, block_size);
+
+	// errors are at different positions of the block, parity bytes included
+	for (int i = 0; i != error_count;)
+	{
+		size_t position = (size_t)rand() % block_size;
+		if (block[position] != original[position])
+			continue;
+		block[position] ^= (uint8_t)(1 + rand() % 255);
+		++i;
+	}
+
+	int corrected = ask_fec_decode(block, block_size);
+	if (corrected != error_count || memcmp(block, original, block_size))
+	{
+		printf("FAIL %u byte block with %i errors, ask_fec_decode returned %i\n", (unsigned int)block_size, error_count, corrected);
+		++failures;
+	}
+}
+
+// bits of the packet that the noise flips, counted from the first bit of the preamble
+static size_t packet_first_bit;
+static size_t noise_first_bit;
+static size_t noise_last_bit;
+
+static int noise()
+{
+	// the transmitter logs the bit it is sending, so the bit on the line is the last logged bit
+	size_t bit = sim_tx_log_size - 1 - packet_first_bit;
+	return bit >= noise_first_bit && bit < noise_last_bit;
+}
+
+static void test_packet(uint32_t flags, int corrupted_length_copy, int corrupted_bytes)
+{
+	transmitter.init(1000, D2, 0x11, (flags & ASK_RECEIVER_FLAG_SCRAMBLED_NRZ) ? (ASK_TRANSMITTER_FLAG_FEC | ASK_TRANSMITTER_FLAG_SCRAMBLED_NRZ) : ASK_TRANSMITTER_FLAG_FEC);
+	receiver.init(1000, D3, 0x22, false, flags);
+	int bits_per_byte = (flags & ASK_RECEIVER_FLAG_SCRAMBLED_NRZ) ? 8 : 12;
+	uint8_t message[32];
+	for (size_t i = 0; i != sizeof(message); ++i)
+		message[i] = (uint8_t)(i * 13 + 1);
+
+	// preamble and start symbol are 48 bits, the length copies are the first three bytes and the corrupted bytes are in the header and the message
+	sim_advance_us(10000);
+	packet_first_bit = sim_tx_log_size;
+	noise_first_bit = 48 + (size_t)(corrupted_length_copy * bits_per_byte) + 1;
+	noise_last_bit = 48 + (size_t)((corrupted_length_copy + 1) * bits_per_byte) - 1;
+	if (corrupted_bytes)
+		noise_last_bit = 48 + (size_t)((3 + corrupted_bytes) * bits_per_byte);
+	transmitter.send(0x22, message, sizeof(message));
+	sim_advance_us(1000000);
+	noise_first_bit = 0;
+	noise_last_bit = 0;
+
+	uint8_t rx_address;
+	uint8_t tx_address;
+	uint8_t received[64];
+	size_t received_size = receiver.recv(&rx_address, &tx_address, received, sizeof(received));
+	ask_receiver_status_t status;
+	receiver.status(&status);
+	if (received_size != sizeof(message) || memcmp(received, message, sizeof(message)) || tx_address != 0x11)
+	{
+		printf("FAIL %s packet with corrupted length copy %i and %i corrupted bytes not received\n", (flags & ASK_RECEIVER_FLAG_SCRAMBLED_NRZ) ? "scrambled NRZ" : "4b6b", corrupted_length_copy, corrupted_bytes);
+		++failures;
+	}
+}
+
+int main()
+{
+	srand(1);
+	for (size_t block_size = ASK_FEC_PARITY_SIZE + 1; block_size <= ASK_FEC_MAXIMUM_BLOCK_SIZE; ++block_size)
+		for (int error_count = 0; error_count <= ASK_FEC_PARITY_SIZE / 2; ++error_count)
+			for (int i = 0; i != 8; ++i)
+				test_block(block_size, error_count);
+
+	sim_noise = noise;
+	for (int nrz = 0; nrz != 2; ++nrz)
+	{
+		uint32_t flags = ASK_RECEIVER_FLAG_FEC | (nrz ? ASK_RECEIVER_FLAG_SCRAMBLED_NRZ : 0);
+		for (int length_copy = 0; length_copy != 3; ++length_copy)
+			test_packet(flags, length_copy, 0);
+		test_packet(flags, 3, ASK_FEC_PARITY_SIZE / 2);
+	}
+	sim_noise = 0;
+
+	printf("%s ask_fec_test\n", failures ? "FAIL" : "PASS");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,190 @@
+// Host loopback test of ask_transmitter_t and ask_receiver_t.
+// Output of the transmitter's interrupt handler and bitstreams rendered by ask_transmitter_t::render are played on the simulated radio line
+// and demodulated by the interrupt handler of the receiver in every line code and with forward error correction.
+// Build and run with run_tests.sh.
+
+#include "mbed.h"
+#include "ask_transmitter.h"
+#include "ask_receiver.h"
+#include "ask_scrambler.h"
+#include <stdlib.h>
+
+static int failures;
+
+// only one transmitter and one receiver object can be initialized during the program, so they are reinitialized for every test
+static ask_transmitter_t transmitter;
+static ask_receiver_t receiver;
+
+static void fill_message(uint8_t* message, size_t message_size, int pattern)
+{
+	// constant bytes test that the scrambled NRZ line code keeps the signal changing
+	for (size_t i = 0; i != message_size; ++i)
+		message[i] = (pattern == 0) ? 0x00 : ((pattern == 1) ? 0xFF : (uint8_t)rand());
+}
+
+static bool receive_message(uint8_t tx_address, const uint8_t* message, size_t message_size)
+{
+	uint8_t rx_address;
+	uint8_t received_tx_address;
+	uint8_t received[ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE];
+	size_t received_size = receiver.recv(&rx_address, &received_tx_address, received, sizeof(received));
+	return received_size == message_size && !memcmp(received, message, message_size) && received_tx_address == tx_address && rx_address == 0x22;
+}
+
+static void test_interrupt_handler(const char* name, uint32_t transmitter_flags, uint32_t receiver_flags, size_t maximum_message_size)
+{
+	transmitter.init(1000, D2, 0x11, transmitter_flags);
+	receiver.init(1000, D3, 0x22, false, receiver_flags);
+	uint8_t message[ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE];
+	size_t message_sizes[] = { 0, 1, 16, 63, maximum_message_size };
+	for (size_t i = 0; i != sizeof(message_sizes) / sizeof(size_t); ++i)
+		for (int pattern = 0; pattern != 3; ++pattern)
+		{
+			fill_message(message, message_sizes[i], pattern);
+			transmitter.send(0x22, message, message_sizes[i]);
+			sim_advance_us((48 + (7 + ASK_FEC_PARITY_SIZE + 2 + message_sizes[i]) * 12 + 64) * 1000);
+			if (!receive_message(0x11, message, message_sizes[i]))
+			{
+				printf("FAIL %s %u byte message pattern %i not received\n", name, (unsigned int)message_sizes[i], pattern);
+				++failures;
+			}
+		}
+
+	// packets of other receivers are not received
+	transmitter.send(0x33, message, 8);
+	sim_advance_us(1000000);
+	if (receiver.recv(message, sizeof(message)))
+	{
+		printf("FAIL %s packet to other receiver received\n", name);
+		++failures;
+	}
+}
+
+static int packets_available()
+{
+	ask_receiver_status_t status;
+	receiver.status(&status);
+	return status.packets_available;
+}
+
+static void test_burst(const char* name, uint32_t transmitter_flags, uint32_t receiver_flags)
+{
+	// packets are queued back to back, so the transmitter sends them in one burst with only the start symbol between them.
+	// packet to other receiver in the middle of the burst is skipped and the receiver finds the start symbol of the next packet
+	transmitter.init(1000, D2, 0x11, transmitter_flags);
+	receiver.init(1000, D3, 0x22, false, receiver_flags);
+	static const uint8_t rx_addresses[] = { 0x22, 0x22, 0x33, 0x22, 0x33, 0x22 };
+	static const size_t message_sizes[] = { 5, 30, 12, 0, 40, 100 };
+	const int packet_count = (int)(sizeof(rx_addresses) / sizeof(uint8_t));
+	uint8_t messages[sizeof(rx_addresses) / sizeof(uint8_t)][100];
+	for (int i = 0; i != packet_count; ++i)
+		fill_message(messages[i], message_sizes[i], i % 3);
+
+	// length of every packet sent alone, including preamble and the low bits after the packet
+	size_t burst_bit_count = 0;
+	for (int i = 0; i != packet_count; ++i)
+	{
+		sim_tx_log_size = 0;
+		transmitter.send(rx_addresses[i], messages[i], message_sizes[i]);
+		sim_advance_us((48 + (7 + message_sizes[i]) * 12 + 64) * 1000);
+		burst_bit_count += sim_tx_log_size;
+		while (packets_available())
+			receiver.recv(0, 0);
+	}
+	// in burst the packets after the first one do not have the preamble or the low bits after the previous packet
+	burst_bit_count -= (size_t)(packet_count - 1) * (36 + 6);
+
+	sim_tx_log_size = 0;
+	for (int i = 0; i != packet_count; ++i)
+		transmitter.send(rx_addresses[i], messages[i], message_sizes[i]);
+	sim_advance_us((burst_bit_count + 64) * 1000);
+	if (sim_tx_log_size != burst_bit_count)
+	{
+		printf("FAIL %s %u bits send instead of one burst of %u bits\n", name, (unsigned int)sim_tx_log_size, (unsigned int)burst_bit_count);
+		++failures;
+	}
+	for (int i = 0; i != packet_count; ++i)
+		if (rx_addresses[i] == 0x22 && !receive_message(0x11, messages[i], message_sizes[i]))
+		{
+			printf("FAIL %s packet %i of burst not received\n", name, i);
+			++failures;
+		}
+	if (packets_available())
+	{
+		printf("FAIL %s packet to other receiver received from burst\n", name);
+		++failures;
+	}
+}
+
+static uint8_t playback_bitstream[ASK_TRANSMITTER_RENDER_BUFFER_SIZE(ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE)];
+static size_t playback_bit_count;
+static size_t playback_bit_index;
+
+static void playback_bit()
+{
+	// plays the rendered bitstream on the line one bit per bit period and keeps the line low after it
+	if (playback_bit_index < playback_bit_count)
+	{
+		sim_line = (playback_bitstream[playback_bit_index >> 3] >> (7 - (playback_bit_index & 7))) & 1;
+		++playback_bit_index;
+	}
+	else
+		sim_line = 0;
+}
+
+static void test_render()
+{
+	transmitter.init(0, NC);
+	receiver.init(1000, D3, 0x22, false, 0);
+	Ticker playback_timer;
+	playback_timer.attach(&playback_bit, 1.0f / 1000.0f);
+	uint8_t message[ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE];
+	size_t message_sizes[] = { 0, 5, 100, ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE };
+	for (size_t i = 0; i != sizeof(message_sizes) / sizeof(size_t); ++i)
+	{
+		fill_message(message, message_sizes[i], 2);
+		playback_bit_count = ask_transmitter_t::render(0x22, 0x44, message, message_sizes[i], playback_bitstream, sizeof(playback_bitstream));
+		playback_bit_index = 0;
+		sim_advance_us((playback_bit_count + 64) * 1000);
+		if (!receive_message(0x44, message, message_sizes[i]))
+		{
+			printf("FAIL rendered %u byte message not received\n", (unsigned int)message_sizes[i]);
+			++failures;
+		}
+	}
+	playback_timer.detach();
+}
+
+static void test_scrambler()
+{
+	// x^7 + x^4 + 1 is primitive, so the state returns to the seed only after 127 bits, which is first time after 127 bytes
+	uint8_t state = ASK_SCRAMBLER_SEED;
+	int byte_count = 0;
+	do
+	{
+		ask_scrambler_sequence(&state);
+		++byte_count;
+	} while (state != ASK_SCRAMBLER_SEED && byte_count != 256);
+	if (byte_count != 127)
+	{
+		printf("FAIL scrambler period is %i bytes\n", byte_count);
+		++failures;
+	}
+}
+
+int main()
+{
+	srand(1);
+	test_scrambler();
+	test_interrupt_handler("4b6b", 0, 0, ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE);
+	test_interrupt_handler("scrambled NRZ", ASK_TRANSMITTER_FLAG_SCRAMBLED_NRZ, ASK_RECEIVER_FLAG_SCRAMBLED_NRZ, ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE);
+	test_interrupt_handler("4b6b FEC", ASK_TRANSMITTER_FLAG_FEC, ASK_RECEIVER_FLAG_FEC, ASK_TRANSMITTER_MAXIMUM_FEC_MESSAGE_SIZE);
+	test_interrupt_handler("scrambled NRZ FEC", ASK_TRANSMITTER_FLAG_SCRAMBLED_NRZ | ASK_TRANSMITTER_FLAG_FEC, ASK_RECEIVER_FLAG_SCRAMBLED_NRZ | ASK_RECEIVER_FLAG_FEC, ASK_TRANSMITTER_MAXIMUM_FEC_MESSAGE_SIZE);
+	test_interrupt_handler("4b6b burst", ASK_TRANSMITTER_FLAG_BURST_MODE, ASK_RECEIVER_FLAG_BURST_MODE, ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE);
+	test_burst("4b6b burst", ASK_TRANSMITTER_FLAG_BURST_MODE, ASK_RECEIVER_FLAG_BURST_MODE);
+	test_burst("scrambled NRZ burst", ASK_TRANSMITTER_FLAG_BURST_MODE | ASK_TRANSMITTER_FLAG_SCRAMBLED_NRZ, ASK_RECEIVER_FLAG_BURST_MODE | ASK_RECEIVER_FLAG_SCRAMBLED_NRZ);
+	test_render();
+
+	printf("%s ask_loopback_test\n", failures ? "FAIL" : "PASS");
+	return failures ? 1 : 0;
+}
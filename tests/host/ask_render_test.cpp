@@ -0,0 +1,99 @@
+// Host test of ask_transmitter_t::render and ask_spi_transmitter_t.
+// The rendered bitstream is compared to the bits written by the interrupt handler of ask_transmitter_t
+// and to the SPI output of ask_spi_transmitter_t decimated by the SPI clock cycles per bit.
+// Build and run with run_tests.sh.
+
+#include "mbed.h"
+#include "ask_transmitter.h"
+#include "ask_spi_transmitter.h"
+#include <stdlib.h>
+
+static uint8_t bitstream[ASK_TRANSMITTER_RENDER_BUFFER_SIZE(ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE)];
+static int failures;
+
+// only one ask_transmitter_t object can be initialized during the program, so it is reinitialized for every packet
+static ask_transmitter_t transmitter;
+
+static int get_bit(const uint8_t* bits, size_t i)
+{
+	return (bits[i >> 3] >> (7 - (i & 7))) & 1;
+}
+
+static void test_packet(int tx_frequency, uint8_t rx_address, uint8_t tx_address, const uint8_t* message, size_t message_size)
+{
+	size_t bit_count = ask_transmitter_t::render(rx_address, tx_address, message, message_size, bitstream, sizeof(bitstream));
+	if (!bit_count || bit_count > ASK_TRANSMITTER_RENDER_BUFFER_SIZE(message_size) * 8)
+	{
+		printf("FAIL render returned %u bits for %u byte message\n", (unsigned int)bit_count, (unsigned int)message_size);
+		++failures;
+		return;
+	}
+
+	// interrupt handler output, one logged bit per bit period
+	{
+		transmitter.init(tx_frequency, D2, tx_address);
+		sim_tx_log_size = 0;
+		transmitter.send(rx_address, message, message_size);
+		sim_advance_us((uint64_t)(bit_count + 64) * 1000000 / tx_frequency);
+		bool match = sim_tx_log_size == bit_count;
+		for (size_t i = 0; match && i != bit_count; ++i)
+			match = sim_tx_log[i] - '0' == get_bit(bitstream, i);
+		if (!match)
+		{
+			printf("FAIL interrupt handler output of %u byte message at %i Hz differs from render\n", (unsigned int)message_size, tx_frequency);
+			++failures;
+		}
+		transmitter.init(0, NC);
+	}
+
+	// SPI output, every bit is repeated for the SPI clock cycles of the bit period
+	{
+		int spi_bits_per_bit = ASK_SPI_TRANSMITTER_DEFAULT_SPI_FREQUENCY / tx_frequency;
+		ask_spi_transmitter_t spi_transmitter(tx_frequency, D2, D3, tx_address);
+		sim_tx_log_size = 0;
+		spi_transmitter.send(rx_address, message, message_size);
+		size_t spi_bit_count = bit_count * (size_t)spi_bits_per_bit;
+		bool match = sim_tx_log_size == ((spi_bit_count + 7) & ~(size_t)7);
+		for (size_t i = 0; match && i != sim_tx_log_size; ++i)
+			match = sim_tx_log[i] - '0' == ((i < spi_bit_count) ? get_bit(bitstream, i / (size_t)spi_bits_per_bit) : 0);
+		if (!match)
+		{
+			printf("FAIL SPI output of %u byte message at %i Hz is not render output oversampled %i times\n", (unsigned int)message_size, tx_frequency, spi_bits_per_bit);
+			++failures;
+		}
+	}
+}
+
+int main()
+{
+	static const int tx_frequencies[] = { 1000, 1250, 2500, 3125 };
+	uint8_t message[ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE];
+	for (size_t i = 0; i != sizeof(message); ++i)
+		message[i] = (uint8_t)(i * 37 + 5);
+
+	for (int f = 0; f != (int)(sizeof(tx_frequencies) / sizeof(int)); ++f)
+	{
+		test_packet(tx_frequencies[f], 0x22, 0x11, (const uint8_t*)"hello", 5);
+		test_packet(tx_frequencies[f], 0x22, 0x11, message, 0);
+		test_packet(tx_frequencies[f], ASK_TRANSMITTER_BROADCAST_ADDRESS, 0x11, message, sizeof(message));
+	}
+	srand(1);
+	for (int i = 0; i != 32; ++i)
+	{
+		size_t size = (size_t)rand() % (sizeof(message) + 1);
+		for (size_t j = 0; j != size; ++j)
+			message[j] = (uint8_t)rand();
+		test_packet(1000, (uint8_t)rand(), (uint8_t)rand(), message, size);
+	}
+
+	// SPI clock that is not a multiple of the bit rate or too slow for SPI peripherals is rejected
+	ask_spi_transmitter_t spi_transmitter;
+	if (spi_transmitter.init(1000, D2, D3, 0x11, 1000) || spi_transmitter.init(3125, D2, D3, 0x11, 250001))
+	{
+		printf("FAIL unreachable SPI clock frequency accepted\n");
+		++failures;
+	}
+
+	printf("%s ask_render_test\n", failures ? "FAIL" : "PASS");
+	return failures ? 1 : 0;
+}
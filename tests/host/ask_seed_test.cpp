@@ -0,0 +1,182 @@
+// Host test of the entropy of seeds returned by ask_receiver_t::get_seed.
+// Only one receiver object can be initialized during the program, so every receiver runs in a child process that is forked before any receiver is initialized.
+// The children begin at the same simulated time and sample the line with the same timing, so they differ only by the noise of the line.
+// Receivers with different noise must give different seeds and receivers with constant line must give equal seeds.
+// rx_entropy is a crc of all samples, so the difference of rx_entropy of a noisy and a constant line is the part that comes from the noise.
+// The difference is tested for bit bias and byte distribution before it is hashed by get_seed, so the hash can not hide missing entropy.
+// Build and run with run_tests.sh.
+
+#include "mbed.h"
+#include "ask_receiver.h"
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define SEED_COUNT 64
+#define ENTROPY_WORD_COUNT 20000
+
+// rx_entropy is read after 64 new samples
+#define ENTROPY_WORD_INTERVAL_US 8000
+
+typedef struct run_t
+{
+	uint64_t first_seed_wait_us;
+	uint32_t seeds[SEED_COUNT];
+	uint32_t rx_entropy[ENTROPY_WORD_COUNT];
+} run_t;
+
+static int failures;
+
+static ask_receiver_t receiver;
+
+static run_t quiet_run;
+static run_t noisy_run;
+static run_t other_run;
+
+static int fair_noise()
+{
+	return rand() & 1;
+}
+
+static int biased_noise()
+{
+	// one of eight samples is flipped, so the entropy of a sample is low
+	return !(rand() & 7);
+}
+
+static void fail(const char* name, const char* test, double value)
+{
+	printf("FAIL %s %s %f\n", name, test, value);
+	++failures;
+}
+
+static bool run_receiver(int (*noise)(), unsigned int noise_seed, run_t* run)
+{
+	int pipe_fds[2];
+	if (pipe(pipe_fds))
+		return false;
+	pid_t child = fork();
+	if (child < 0)
+		return false;
+	if (!child)
+	{
+		// the child initializes the only receiver of its process and sends the seeds and rx_entropy words to the parent
+		close(pipe_fds[0]);
+		srand(noise_seed);
+		sim_noise = noise;
+		receiver.init(1000, D3, 0x22);
+		uint64_t wait_begin = sim_time_ns;
+		run->seeds[0] = receiver.get_seed();
+		run->first_seed_wait_us = (sim_time_ns - wait_begin) / 1000;
+		for (int i = 1; i != SEED_COUNT; ++i)
+		{
+			sim_advance_us(1000);
+			run->seeds[i] = receiver.get_seed();
+		}
+		for (int i = 0; i != ENTROPY_WORD_COUNT; ++i)
+		{
+			sim_advance_us(ENTROPY_WORD_INTERVAL_US);
+			run->rx_entropy[i] = receiver.rx_entropy;
+		}
+		for (size_t written = 0; written != sizeof(run_t);)
+		{
+			ssize_t size = write(pipe_fds[1], (const char*)run + written, sizeof(run_t) - written);
+			if (size <= 0)
+				_exit(1);
+			written += (size_t)size;
+		}
+		_exit(0);
+	}
+
+	close(pipe_fds[1]);
+	size_t received = 0;
+	while (received != sizeof(run_t))
+	{
+		ssize_t size = read(pipe_fds[0], (char*)run + received, sizeof(run_t) - received);
+		if (size <= 0)
+			break;
+		received += (size_t)size;
+	}
+	close(pipe_fds[0]);
+	int status;
+	return waitpid(child, &status, 0) == child && WIFEXITED(status) && !WEXITSTATUS(status) && received == sizeof(run_t);
+}
+
+static void test_noise_entropy(const char* name)
+{
+	// the crc of the constant line cancels out, so the difference is zero if the noise does not reach rx_entropy
+	static uint32_t difference[ENTROPY_WORD_COUNT];
+	for (int i = 0; i != ENTROPY_WORD_COUNT; ++i)
+		difference[i] = noisy_run.rx_entropy[i] ^ quiet_run.rx_entropy[i];
+
+	// proportion of one bits and the largest bias of single bit position as standard deviations
+	long ones = 0;
+	double worst_bit_z = 0;
+	for (int b = 0; b != 32; ++b)
+	{
+		long bit_ones = 0;
+		for (int i = 0; i != ENTROPY_WORD_COUNT; ++i)
+			bit_ones += (difference[i] >> b) & 1;
+		ones += bit_ones;
+		double z = fabs((double)bit_ones - ENTROPY_WORD_COUNT / 2.0) / sqrt(ENTROPY_WORD_COUNT / 4.0);
+		if (z > worst_bit_z)
+			worst_bit_z = z;
+	}
+	double monobit = (double)ones / (32.0 * ENTROPY_WORD_COUNT);
+	if (fabs(monobit - 0.5) > 0.002)
+		fail(name, "rx_entropy noise proportion of one bits", monobit);
+	if (worst_bit_z > 4.5)
+		fail(name, "rx_entropy noise worst bit position bias z", worst_bit_z);
+
+	// chi-square of the byte distribution with 255 degrees of freedom, 99.9% bound is 330.5
+	static long histogram[256];
+	memset(histogram, 0, sizeof(histogram));
+	for (int i = 0; i != ENTROPY_WORD_COUNT; ++i)
+		for (int k = 0; k != 4; ++k)
+			histogram[(difference[i] >> (k * 8)) & 0xFF]++;
+	double expected = 4.0 * ENTROPY_WORD_COUNT / 256.0;
+	double chi_square = 0;
+	for (int i = 0; i != 256; ++i)
+		chi_square += ((double)histogram[i] - expected) * ((double)histogram[i] - expected) / expected;
+	if (chi_square > 330.5)
+		fail(name, "rx_entropy noise byte chi-square", chi_square);
+}
+
+static void test_seeds(const char* name, int (*noise)())
+{
+	if (!run_receiver(noise, 1, &noisy_run) || !run_receiver(noise, 2, &other_run))
+	{
+		fail(name, "receiver process", 0);
+		return;
+	}
+
+	// first seed waits for the pool to be filled, it should not take more than a second
+	if (noisy_run.first_seed_wait_us > 1000000)
+		fail(name, "first seed wait in us", (double)noisy_run.first_seed_wait_us);
+
+	// receivers that differ only by the noise of the line give different seeds
+	int equal_seeds = 0;
+	for (int i = 0; i != SEED_COUNT; ++i)
+		if (noisy_run.seeds[i] == other_run.seeds[i])
+			++equal_seeds;
+	if (noisy_run.seeds[0] == other_run.seeds[0] || equal_seeds)
+		fail(name, "seeds equal to seeds with other noise", (double)equal_seeds);
+
+	test_noise_entropy(name);
+}
+
+int main()
+{
+	// receivers of constant line with the same timing give the same seeds, so the seeds come from the line
+	if (!run_receiver(0, 1, &quiet_run) || !run_receiver(0, 2, &other_run))
+		fail("constant line", "receiver process", 0);
+	else if (memcmp(&quiet_run, &other_run, sizeof(run_t)))
+		fail("constant line", "seeds differ with same samples", 0);
+
+	test_seeds("fair noise", fair_noise);
+	test_seeds("biased noise", biased_noise);
+
+	printf("%s ask_seed_test\n", failures ? "FAIL" : "PASS");
+	return failures ? 1 : 0;
+}
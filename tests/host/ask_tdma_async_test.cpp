@@ -0,0 +1,333 @@
+// Host test of ask_tdma_async_client_t with the threads of the mbed OS stub.
+// The base station is simulated in its own thread with the frame functions of ask_tdma.cpp, because only one receiver and one transmitter object can be initialized during the program.
+// It plays frame synchronization packets on the line and decodes the packets of the client from the bits the client's transmitter has written.
+// Build and run with run_tests.sh.
+
+#include "mbed.h"
+#include "../../ask_tdma.cpp"
+#include <stdlib.h>
+
+#define BIT_RATE 1000
+#define BASE_STATION_ADDRESS 0x01
+#define OTHER_CLIENT_ADDRESS 0x44
+
+typedef struct packet_t
+{
+	uint8_t rx_address;
+	uint8_t tx_address;
+	uint8_t message[ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE];
+	size_t size;
+} packet_t;
+
+static int failures;
+
+static ask_tdma_server_t server;
+static Thread base_station_thread;
+static volatile bool base_station_running;
+
+// decoded byte of every 12 bit symbol pair written by the transmitter, -1 for invalid symbols
+static int16_t symbol_bytes[1 << 12];
+static size_t tx_log_position;
+
+// packets played on the line by the simulated base station
+static uint8_t playback[2 * ASK_TRANSMITTER_RENDER_BUFFER_SIZE(ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE)];
+static size_t playback_size;
+static size_t playback_index;
+static Ticker playback_ticker;
+
+// express message to the client that the base station plays after the next frame synchronization packet
+static volatile bool express_message_pending;
+static uint8_t express_message_rx_address;
+static uint8_t express_message_data;
+
+// messages to the other client that were decoded from the air
+static uint8_t received_messages[16][ASK_TDMA_ASYNC_MAXIMUM_MESSAGE_SIZE];
+static size_t received_message_sizes[16];
+static volatile int received_message_count;
+static size_t transfer_size;
+static size_t transfer_received;
+static volatile int leave_messages;
+
+static void fail(const char* test)
+{
+	printf("FAIL %s\n", test);
+	++failures;
+}
+
+static int get_bit(const uint8_t* bits, size_t i)
+{
+	return (bits[i >> 3] >> (7 - (i & 7))) & 1;
+}
+
+static void play_bit()
+{
+	if (playback_index != playback_size)
+		sim_line = get_bit(playback, playback_index++);
+	else
+	{
+		sim_line = 0;
+		playback_ticker.detach();
+	}
+}
+
+static void initialize_symbol_bytes()
+{
+	// the symbols of a byte are at the message of a rendered one byte packet after preamble and 5 header bytes
+	uint8_t bits[ASK_TRANSMITTER_RENDER_BUFFER_SIZE(1)];
+	for (int i = 0; i != (1 << 12); ++i)
+		symbol_bytes[i] = -1;
+	for (int b = 0; b != 256; ++b)
+	{
+		uint8_t byte = (uint8_t)b;
+		ask_transmitter_t::render(0, 0, &byte, 1, bits, sizeof(bits));
+		int symbol = 0;
+		for (int i = 0; i != 12; ++i)
+			symbol = (symbol << 1) | get_bit(bits, 48 + 5 * 12 + i);
+		symbol_bytes[symbol] = (int16_t)b;
+	}
+}
+
+static bool decode_byte(size_t bit_index, uint8_t* byte)
+{
+	int symbol = 0;
+	for (int i = 0; i != 12; ++i)
+		symbol = (symbol << 1) | (sim_tx_log[bit_index + i] - '0');
+	if (symbol_bytes[symbol] < 0)
+		return false;
+	*byte = (uint8_t)symbol_bytes[symbol];
+	return true;
+}
+
+static bool decode_next_packet(packet_t* packet)
+{
+	// the transmitter writes only the bits of its packets, so the log is a sequence of whole packets
+	uint8_t length;
+	if (tx_log_position + 60 > sim_tx_log_size || !decode_byte(tx_log_position + 48, &length) || length < 7)
+		return false;
+	if (tx_log_position + 48 + (size_t)length * 12 + 6 > sim_tx_log_size)
+		return false;
+	uint8_t bytes[256];
+	for (int i = 0; i != length; ++i)
+		if (!decode_byte(tx_log_position + 48 + (size_t)i * 12, bytes + i))
+			return false;
+	tx_log_position += 48 + (size_t)length * 12 + 6;
+	packet->rx_address = bytes[1];
+	packet->tx_address = bytes[2];
+	packet->size = (size_t)length - 7;
+	memcpy(packet->message, bytes + 5, packet->size);
+	return true;
+}
+
+static void record_packet(const packet_t* packet)
+{
+	if (packet->rx_address == BASE_STATION_ADDRESS && packet->size && (packet->message[0] & 0xF) == ASK_TDMA_LEAVE_MESSAGE)
+		leave_messages++;
+	if (packet->rx_address != OTHER_CLIENT_ADDRESS || !packet->size || received_message_count == 16)
+		return;
+
+	// messages are reassembled from express messages and transfers as the other client would receive them
+	uint8_t* message = received_messages[received_message_count];
+	if ((packet->message[0] & 0xF) == ASK_TDMA_EXPRESS_MESSAGE)
+	{
+		memcpy(message, packet->message + 1, packet->size - 1);
+		received_message_sizes[received_message_count++] = packet->size - 1;
+	}
+	else if ((packet->message[0] & 0x1F) == ASK_TDMA_TRANSFER_MESSAGE && packet->size == 4)
+	{
+		transfer_size = (size_t)packet->message[1] | ((size_t)packet->message[2] << 8);
+		transfer_received = 0;
+	}
+	else if ((packet->message[0] & 0xF) == ASK_TDMA_DATA_MESSAGE && transfer_received + packet->size - 1 <= transfer_size)
+	{
+		memcpy(message + transfer_received, packet->message + 1, packet->size - 1);
+		transfer_received += packet->size - 1;
+		if (transfer_received == transfer_size)
+			received_message_sizes[received_message_count++] = transfer_size;
+	}
+}
+
+static void start_simulated_server()
+{
+	// the server is initialized like start_server does without the radio, the rest of the static server is zero
+	for (uint8_t i = 0; i != 16; ++i)
+		server.data_slots[i].address = ASK_RECEIVER_BROADCAST_ADDRESS;
+	reserve_address(server.reserved_addresses, ASK_RECEIVER_BROADCAST_ADDRESS);
+	reserve_address(server.reserved_addresses, BASE_STATION_ADDRESS);
+	server.xorshift32_state = 0x12345678;
+	server.data_packet_size = ASK_TDMA_DEFAULT_DATA_PACKET_SIZE;
+	while (data_packet_sizes[server.data_packet_size_index] != ASK_TDMA_DEFAULT_DATA_PACKET_SIZE)
+		server.data_packet_size_index++;
+	server.bit_rate = BIT_RATE;
+	server.us_per_bit = 1000000 / BIT_RATE;
+	server.join_slot_count = 1;
+	server.receiver.rx_address = BASE_STATION_ADDRESS;
+	server.transmitter.tx_address = BASE_STATION_ADDRESS;
+}
+
+static void play_frame_synchronization_message(uint8_t synchronization_message_size)
+{
+	// renames are send after the header when there is no slot map, like send_frame_synchronization_message does
+	uint8_t message[ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE];
+	uint8_t header_size = get_synchronization_header_size(server.message_buffer, synchronization_message_size);
+	if (server.message_buffer[2] & ASK_TDMA_SLOT_MAP_FLAG)
+		memcpy(message, server.message_buffer, synchronization_message_size);
+	else
+	{
+		memcpy(message, server.message_buffer, header_size);
+		memcpy(message + header_size, server.renames, (size_t)server.rename_count << 1);
+	}
+	playback_size = ask_transmitter_t::render(ASK_RECEIVER_BROADCAST_ADDRESS, BASE_STATION_ADDRESS, message, synchronization_message_size, playback, sizeof(playback) / 2);
+
+	// express message from the other client is played in the join slot, after a gap of low bits
+	if (express_message_pending)
+	{
+		uint8_t express_message[2] = { ASK_TDMA_EXPRESS_MESSAGE, express_message_data };
+		uint8_t bits[ASK_TRANSMITTER_RENDER_BUFFER_SIZE(2)];
+		size_t bit_count = ask_transmitter_t::render(express_message_rx_address, OTHER_CLIENT_ADDRESS, express_message, 2, bits, sizeof(bits));
+		for (size_t i = 0; i != 8 + bit_count; ++i, ++playback_size)
+			if (i >= 8 && get_bit(bits, i - 8))
+				playback[playback_size >> 3] |= (uint8_t)(0x80 >> (playback_size & 7));
+			else
+				playback[playback_size >> 3] &= (uint8_t)~(0x80 >> (playback_size & 7));
+		express_message_pending = false;
+	}
+	playback_index = 0;
+	playback_ticker.attach_us(play_bit, 1000000 / BIT_RATE);
+}
+
+static void run_base_station()
+{
+	start_simulated_server();
+	uint8_t synchronization_message_size = write_frame_synchronization_message(&server, false);
+	while (base_station_running)
+	{
+		// the frame begins with the frame synchronization packet
+		play_frame_synchronization_message(synchronization_message_size);
+		begin_frame(&server, synchronization_message_size);
+		wait_us(server.frame_length);
+
+		// packets of the frame are processed as if the base station had received them, it receives packets to all addresses.
+		// packet that is still on air at the end of the frame is waited for, so the receiver's delay does not move it to the next frame
+		packet_t packet;
+		for (int i = 0; i != 8 && tx_log_position != sim_tx_log_size; ++i)
+		{
+			while (decode_next_packet(&packet))
+			{
+				record_packet(&packet);
+				memcpy(server.message_buffer, packet.message, packet.size);
+				process_frame_message(&server, packet.rx_address, packet.tx_address, packet.size);
+			}
+			if (tx_log_position != sim_tx_log_size)
+				wait_us(1000000 / BIT_RATE);
+		}
+
+		// end the frame as ask_tdma_base_station_t::step does
+		ask_tdma_data_slot_t join_request;
+		end_frame(&server, &join_request);
+		bool join_request_accepted = process_frame_renaming(&server, (join_request.usage < 0) ? 0 : &join_request);
+		synchronization_message_size = write_frame_synchronization_message(&server, join_request_accepted);
+		server.frame_number++;
+		server.frame_count++;
+	}
+}
+
+static int client_count()
+{
+	int count = 0;
+	for (int i = 0; i != server.data_slot_count; ++i)
+		if (server.data_slots[i].address != ASK_RECEIVER_BROADCAST_ADDRESS)
+			count++;
+	return count;
+}
+
+static void test_async_client()
+{
+	static ask_tdma_async_client_t client;
+	initialize_symbol_bytes();
+
+	// the base station plays its packets on the line and the client does not receive its own packets
+	sim_tx_muted = true;
+	tx_log_position = sim_tx_log_size;
+	base_station_running = true;
+	base_station_thread.start(run_base_station);
+	if (client.start(D3, D2, BIT_RATE))
+		fail("start of client");
+
+	// client joins the network
+	for (int i = 0; i != 100 && !client_count(); ++i)
+		wait_ms(100);
+	if (client_count() != 1 || client.get_error())
+		fail("join of async client");
+
+	// send queue holds ASK_TDMA_ASYNC_QUEUE_LENGTH messages. the client thread does not run between the sends, so the queue is full after them
+	static const char messages[ASK_TDMA_ASYNC_QUEUE_LENGTH + 1][64] = { "first", "second message that is longer than one data packet", "3", "fourth", "fifth" };
+	for (int i = 0; i != ASK_TDMA_ASYNC_QUEUE_LENGTH; ++i)
+		if (client.send(OTHER_CLIENT_ADDRESS, strlen(messages[i]), messages[i], 0))
+			fail("send to send queue with free space");
+	uint64_t full_queue_time = sim_time_ns;
+	if (client.send(OTHER_CLIENT_ADDRESS, 5, messages[ASK_TDMA_ASYNC_QUEUE_LENGTH], 0) != ASK_TDMA_ERROR_TIMEOUT)
+		fail("send to full send queue without waiting");
+	if (client.send(OTHER_CLIENT_ADDRESS, 5, messages[ASK_TDMA_ASYNC_QUEUE_LENGTH], osWaitForever))
+		fail("send to full send queue waiting forever");
+	if (sim_time_ns == full_queue_time)
+		fail("send to full send queue did not wait");
+
+	// all messages are send on air in order
+	for (int i = 0; i != 200 && received_message_count != ASK_TDMA_ASYNC_QUEUE_LENGTH + 1; ++i)
+		wait_ms(100);
+	if (received_message_count != ASK_TDMA_ASYNC_QUEUE_LENGTH + 1)
+		fail("messages send on air");
+	for (int i = 0; i != received_message_count && i != ASK_TDMA_ASYNC_QUEUE_LENGTH + 1; ++i)
+		if (received_message_sizes[i] != strlen(messages[i]) || memcmp(received_messages[i], messages[i], received_message_sizes[i]))
+			fail("message send on air");
+
+	// recv waits until timeout for message and returns express message from the other client
+	uint8_t message[ASK_TDMA_ASYNC_MAXIMUM_MESSAGE_SIZE];
+	uint8_t rx_address;
+	uint8_t tx_address;
+	size_t message_size;
+	uint64_t recv_begin = sim_time_ns;
+	if (client.recv(100, sizeof(message), message, &rx_address, &tx_address, &message_size) != ASK_TDMA_ERROR_TIMEOUT || sim_time_ns - recv_begin < 100000000)
+		fail("recv from empty receive queue");
+	express_message_rx_address = server.data_slots[0].address;
+	express_message_data = 0xA5;
+	express_message_pending = true;
+	if (client.recv(10000, sizeof(message), message, &rx_address, &tx_address, &message_size) || message_size != 1 || message[0] != 0xA5 || tx_address != OTHER_CLIENT_ADDRESS || rx_address != express_message_rx_address)
+		fail("recv of express message");
+
+	// stop leaves the network and send fails after it
+	client.stop();
+	if (!leave_messages || client_count())
+		fail("leave of stopped client");
+	if (client.send(OTHER_CLIENT_ADDRESS, 5, messages[0], 0) != ASK_TDMA_ERROR_NO_NETWORK)
+		fail("send after stop");
+
+	base_station_running = false;
+	base_station_thread.join();
+}
+
+static void test_retry_delay()
+{
+	// receiver of the first client is the only receiver of the program, so every join of another client fails at once
+	static ask_tdma_async_client_t client;
+	uint64_t begin = sim_time_ns;
+	if (client.start(D3, D2, BIT_RATE))
+		fail("start of client that can not join");
+	wait_ms(1000);
+	if (client.get_error() != ASK_TDMA_ERROR_RECEIVER_ERROR)
+		fail("error of client that can not join");
+
+	// the client thread sleeps between the retries, so the main thread runs and stop returns after the delay
+	client.stop();
+	if (sim_time_ns - begin > 3000000000u)
+		fail("stop of client that retries joining");
+}
+
+int main()
+{
+	test_async_client();
+	test_retry_delay();
+
+	printf("%s ask_tdma_async_test\n", failures ? "FAIL" : "PASS");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,238 @@
+// Host simulation of many clients joining a network at the same time.
+// The base station is the real code of ask_tdma.cpp and the clients choose join slots, back off and time their join requests with get_join_request_time like ask_tdma_client_t::join.
+// Each client processes the frame synchronization message after a random delay and has a random error in its estimate of the base station clock.
+// Join requests that overlap on air are lost.
+// Build and run with run_tests.sh.
+
+#include "mbed.h"
+#include "../../ask_tdma.cpp"
+#include <stdlib.h>
+
+#define MAXIMUM_CLIENT_COUNT 256
+#define RUN_COUNT 10
+#define MAXIMUM_FRAME_COUNT 2000
+
+// length of join request packet of two bytes in bits
+#define JOIN_REQUEST_LENGTH (132 + 2 * 12 + 6)
+
+// largest error of the client's estimate of the base station clock in bits
+#define MAXIMUM_CLOCK_ERROR 6
+
+typedef struct client_t
+{
+	bool joined;
+	uint8_t address;
+	bool join_request_send;
+	bool join_request_failed;
+	int join_requests_failed;
+	int backoff_frames;
+	uint32_t xorshift32_state;
+	uint8_t join_identity;
+	int join_request_begin;
+} client_t;
+
+typedef struct result_t
+{
+	int frames;
+	long bits;
+	int wrong_joins;
+	int skipped_join_requests;
+	int join_requests_overlapping_other_slots;
+} result_t;
+
+static int failures;
+
+// base station object is reused, because only one receiver and one transmitter object can be initialized during the program
+static ask_tdma_server_t server;
+
+static client_t clients[MAXIMUM_CLIENT_COUNT];
+
+static uint32_t random_state;
+
+static uint32_t random_value()
+{
+	random_state = xorshift32(random_state);
+	return random_state;
+}
+
+static int random_noise()
+{
+	return rand() & 1;
+}
+
+static int processing_delay()
+{
+	// most frame synchronization messages are processed immediately, but some are processed late like the message cached by listen
+	if (!(random_value() % 20))
+		return (int)(random_value() % ASK_TDMA_SYNCHRONIZATION_MAXIMUM_AGE);
+	return (int)(random_value() % 8);
+}
+
+static int clock_error()
+{
+	// the transmitter begins the packet at the first bit period after the scheduled time
+	return (int)(random_value() % (2 * MAXIMUM_CLOCK_ERROR + 1)) - MAXIMUM_CLOCK_ERROR + (int)(random_value() & 1);
+}
+
+static bool simulate(int client_count, int join_slot_count, uint32_t seed, result_t* result)
+{
+	if (start_server(D3, D2, 1000, 0x01, ASK_TDMA_DEFAULT_DATA_PACKET_SIZE, join_slot_count, &server))
+		return false;
+	random_state = seed;
+	for (int i = 0; i != client_count; ++i)
+	{
+		clients[i].joined = false;
+		clients[i].join_request_send = false;
+		clients[i].join_request_failed = false;
+		clients[i].join_requests_failed = 0;
+		clients[i].backoff_frames = 0;
+		// consecutive states of the same xorshift32 sequence would give clients the same random values one step apart, so the seeds are scrambled
+		do
+			clients[i].xorshift32_state = random_value() * 0x9E3779B9u;
+		while (!clients[i].xorshift32_state);
+	}
+	memset(result, 0, sizeof(result_t));
+
+	uint8_t synchronization_message[ASK_TDMA_MAXIMUM_DATA_PACKET_SIZE];
+	uint8_t synchronization_message_size = write_frame_synchronization_message(&server, false);
+	memcpy(synchronization_message, server.message_buffer, synchronization_message_size);
+	begin_frame(&server, synchronization_message_size);
+	for (int frame = 1; frame != MAXIMUM_FRAME_COUNT; ++frame)
+	{
+		result->bits += (132 + (long)synchronization_message_size * 12) + ASK_TDMA_JOIN_SLOTS_LENGTH(join_slot_count);
+		for (int i = 0; i != server.data_slot_count; ++i)
+			result->bits += (long)server.data_slots[i].length * ASK_TDMA_DATA_PACKET_LENGTH(server.data_packet_size);
+
+		// clients that are not backing off send join request in random join slot
+		for (int i = 0; i != client_count; ++i)
+		{
+			client_t* client = clients + i;
+			if (client->joined)
+				continue;
+			client_t previous_client = *client;
+			client->join_request_begin = get_join_request_time(join_slot_count, processing_delay(), client->join_request_failed, &client->join_requests_failed, &client->backoff_frames, &client->xorshift32_state, &client->join_identity);
+			client->join_request_failed = false;
+			if (client->join_request_begin < 0)
+			{
+				// the join request was skipped if it would have been send without the processing delay
+				if (get_join_request_time(join_slot_count, 0, previous_client.join_request_failed, &previous_client.join_requests_failed, &previous_client.backoff_frames, &previous_client.xorshift32_state, &previous_client.join_identity) >= 0)
+					result->skipped_join_requests++;
+				continue;
+			}
+			client->join_request_begin += clock_error();
+			client->join_request_send = true;
+		}
+
+		// connected clients send one data packet in their data slots
+		for (int i = 0; i != client_count; ++i)
+			if (clients[i].joined)
+			{
+				server.message_buffer[0] = ASK_TDMA_DATA_MESSAGE;
+				server.message_buffer[1] = 0;
+				process_frame_message(&server, server.receiver.rx_address, clients[i].address, 2);
+			}
+
+		// the base station receives join requests that do not overlap any other join request in the order they were send
+		for (int t = -MAXIMUM_CLOCK_ERROR; t <= ASK_TDMA_JOIN_SLOTS_LENGTH(join_slot_count) + MAXIMUM_CLOCK_ERROR + 1; ++t)
+			for (int i = 0; i != client_count; ++i)
+				if (clients[i].join_request_send && clients[i].join_request_begin == t)
+				{
+					bool overlap = false;
+					for (int j = 0; j != client_count; ++j)
+						if (j != i && clients[j].join_request_send && clients[j].join_request_begin < t + JOIN_REQUEST_LENGTH && t < clients[j].join_request_begin + JOIN_REQUEST_LENGTH)
+						{
+							overlap = true;
+							if ((clients[j].join_identity & 0x7) != (clients[i].join_identity & 0x7))
+								result->join_requests_overlapping_other_slots++;
+						}
+					if (!overlap)
+					{
+						server.message_buffer[0] = ASK_TDMA_JOIN_MESSAGE;
+						server.message_buffer[1] = clients[i].join_identity;
+						process_frame_message(&server, server.receiver.rx_address, ASK_RECEIVER_BROADCAST_ADDRESS, 2);
+					}
+				}
+
+		// end the frame as ask_tdma_base_station_t::step does
+		ask_tdma_data_slot_t join_request;
+		end_frame(&server, &join_request);
+		bool join_request_accepted = process_frame_renaming(&server, (join_request.usage < 0) ? 0 : &join_request);
+		synchronization_message_size = write_frame_synchronization_message(&server, join_request_accepted);
+		memcpy(synchronization_message, server.message_buffer, synchronization_message_size);
+		server.frame_number++;
+		server.frame_count++;
+		begin_frame(&server, synchronization_message_size);
+
+		// clients that send join request test if the base station accepted it, the accepted client gets its address from the slot map
+		int accepted_clients = 0;
+		for (int i = 0; i != client_count; ++i)
+		{
+			client_t* client = clients + i;
+			if (!client->join_request_send)
+				continue;
+			client->join_request_send = false;
+			if ((synchronization_message[0] & 0x10) && (synchronization_message[2] & ASK_TDMA_SLOT_MAP_FLAG) && synchronization_message[3] == client->join_identity)
+			{
+				client->joined = true;
+				client->address = synchronization_message[4 + (synchronization_message[2] >> 4)];
+				accepted_clients++;
+			}
+			else
+				client->join_request_failed = true;
+		}
+		if (accepted_clients > 1)
+			result->wrong_joins += accepted_clients - 1;
+
+		int connected_clients = 0;
+		for (int i = 0; i != server.data_slot_count; ++i)
+			if (server.data_slots[i].address != ASK_RECEIVER_BROADCAST_ADDRESS)
+				connected_clients++;
+		if (connected_clients == 16)
+		{
+			result->frames = frame;
+			return true;
+		}
+	}
+	return false;
+}
+
+int main()
+{
+	static const int client_counts[] = { 16, 128, 256 };
+	sim_noise = random_noise;
+	for (int c = 0; c != (int)(sizeof(client_counts) / sizeof(int)); ++c)
+		for (int join_slot_count = 1; join_slot_count <= ASK_TDMA_MAXIMUM_JOIN_SLOT_COUNT; join_slot_count <<= 1)
+		{
+			result_t total;
+			memset(&total, 0, sizeof(result_t));
+			int failed_runs = 0;
+			for (int run = 0; run != RUN_COUNT; ++run)
+			{
+				result_t result;
+				if (!simulate(client_counts[c], join_slot_count, 0x9E3779B9u * (uint32_t)(run + 1), &result))
+				{
+					failed_runs++;
+					continue;
+				}
+				total.frames += result.frames;
+				total.bits += result.bits;
+				total.wrong_joins += result.wrong_joins;
+				total.skipped_join_requests += result.skipped_join_requests;
+				total.join_requests_overlapping_other_slots += result.join_requests_overlapping_other_slots;
+			}
+			int runs = (failed_runs != RUN_COUNT) ? RUN_COUNT - failed_runs : 1;
+			printf("%3d clients %d join slots: frames %6.1f time %6.1f s at 1000 bit/s, skipped %5.1f, overlapping other slots %5.1f, wrong joins %d, runs not filled %d\n",
+				client_counts[c], join_slot_count,
+				(double)total.frames / runs, (double)total.bits / runs / 1000.0, (double)total.skipped_join_requests / runs, (double)total.join_requests_overlapping_other_slots / runs, total.wrong_joins, failed_runs);
+
+			// with the guard interval join requests of different join slots never overlap and every network is filled
+			if (failed_runs || total.wrong_joins || total.join_requests_overlapping_other_slots)
+			{
+				printf("FAIL %d clients joining network with %d join slots\n", client_counts[c], join_slot_count);
+				++failures;
+			}
+		}
+
+	printf("%s ask_tdma_join_test\n", failures ? "FAIL" : "PASS");
+	return failures ? 1 : 0;
+}
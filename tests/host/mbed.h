@@ -0,0 +1,125 @@
+// Host stub of the mbed OS APIs used by mbed-os-ask for the host tests in this directory.
+// Tickers run in simulated time that only advances in sim_advance_us and the radio is a single line shared by all pins.
+// The tx pin is D2, bits written to it and bits written by SPI are logged to sim_tx_log.
+// When sim_tx_muted is set, bits written to D2 are only logged, like by a half duplex radio that does not receive its own packets.
+// sim_noise can be set to a function that returns 1 to flip the line value of a read.
+// Threads are coroutines that run one at a time. A thread runs until it sleeps, waits or polls a Timer, then the thread that wakes up first runs.
+// Polling and waiting take SIM_POLL_US of simulated time while other threads are running, so busy loops of a thread let the others run.
+#ifndef SIM_MBED_H
+#define SIM_MBED_H
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include <stdio.h>
+#include <string.h>
+typedef enum { NC = -1, D2 = 2, D3 = 3, D4 = 4, D5 = 5, D6 = 6, LED1 = 7 } PinName;
+typedef enum { PIN_INPUT, PIN_OUTPUT } PinDirection;
+typedef enum { PullNone } PinMode;
+typedef struct { PinName pin; } gpio_t;
+extern int sim_line;           // simulated radio line
+extern uint64_t sim_time_ns;   // simulated time
+void sim_advance_us(uint64_t us);
+void sim_sleep_us(uint64_t us);
+void sim_poll();
+#define SIM_POLL_US 100
+inline void gpio_init_out_ex(gpio_t* g, PinName p, int v) { g->pin = p; if (p != NC) sim_line = v; }
+inline void gpio_init_inout(gpio_t* g, PinName p, PinDirection, PinMode, int) { g->pin = p; }
+inline void gpio_init_in(gpio_t* g, PinName p) { g->pin = p; }
+inline void gpio_dir(gpio_t*, PinDirection) {}
+extern char sim_tx_log[1 << 20]; extern size_t sim_tx_log_size;
+extern bool sim_tx_muted;
+inline void gpio_write(gpio_t* g, int v) { if (g->pin == D2) { if (!sim_tx_muted) sim_line = v; if (sim_tx_log_size != sizeof(sim_tx_log)) sim_tx_log[sim_tx_log_size++] = '0' + v; } }
+extern int (*sim_noise)();
+inline int gpio_read(gpio_t*) { return sim_line ^ (sim_noise ? sim_noise() : 0); }
+inline void core_util_critical_section_enter() {}
+inline void core_util_critical_section_exit() {}
+inline uint32_t us_ticker_read() { return (uint32_t)(sim_time_ns / 1000); }
+class Ticker {
+public:
+	Ticker();
+	~Ticker();
+	void attach(void (*f)(), float t) { fn = f; period_ns = (uint64_t)(t * 1e9 + 0.5); next_ns = sim_time_ns + period_ns; }
+	void attach_us(void (*f)(), uint64_t t) { fn = f; period_ns = t * 1000; next_ns = sim_time_ns + period_ns; }
+	void detach() { fn = 0; }
+	void (*fn)();
+	bool oneshot;
+	uint64_t period_ns;
+	uint64_t next_ns;
+	Ticker* next;
+};
+class Timeout : public Ticker {
+public:
+	void attach_us(void (*f)(), uint64_t t) { Ticker::attach_us(f, t); oneshot = true; }
+};
+class Timer {
+public:
+	Timer() : running(false), acc(0), start_ns(0) {}
+	void start() { if (!running) { running = true; start_ns = sim_time_ns; } }
+	void stop() { if (running) { acc += sim_time_ns - start_ns; running = false; } }
+	void reset() { acc = 0; start_ns = sim_time_ns; }
+	int read_us() { sim_poll(); return (int)((acc + (running ? sim_time_ns - start_ns : 0)) / 1000); }
+	bool running; uint64_t acc, start_ns;
+};
+inline void wait_us(int us) { sim_sleep_us((uint64_t)us); }
+inline void wait_ms(int ms) { sim_sleep_us((uint64_t)ms * 1000); }
+class SPI {
+public:
+	SPI(PinName mosi, PinName miso, PinName sclk) {}
+	~SPI() {}
+	void format(int, int) {}
+	void frequency(int) {}
+	int write(const char* tx, int n, char*, int) { for (int i = 0; i != n * 8; ++i) if (sim_tx_log_size != sizeof(sim_tx_log)) sim_tx_log[sim_tx_log_size++] = '0' + ((tx[i >> 3] >> (7 - (i & 7))) & 1); return n; }
+};
+typedef enum { osOK = 0, osEventMail = 0x20, osEventTimeout = 0x40, osErrorResource = -3 } osStatus;
+typedef enum { osPriorityNormal = 0 } osPriority;
+#define osWaitForever 0xFFFFFFFFu
+#define OS_STACK_SIZE 4096
+struct osEvent { osStatus status; union { void* p; uint32_t v; } value; };
+template <typename F> struct Callback { F* f; };
+template <typename T, typename M> struct MemberCallback { T* o; M m; };
+template <typename T, typename M> MemberCallback<T, M> callback(T* o, M m) { MemberCallback<T, M> c = { o, m }; return c; }
+struct sim_thread_t;
+sim_thread_t* sim_thread_start(void (*entry)(void*), void* argument);
+bool sim_thread_finished(sim_thread_t* thread);
+void sim_thread_free(sim_thread_t* thread);
+// sleeps SIM_POLL_US and returns true, if done is false and the simulated time is before end_ns
+bool sim_wait(bool done, uint64_t end_ns);
+inline uint64_t sim_wait_end(uint32_t millisec) { return (millisec == osWaitForever) ? UINT64_MAX : sim_time_ns + (uint64_t)millisec * 1000000; }
+template <typename T, typename M> void sim_call_member(void* c) { MemberCallback<T, M>* f = (MemberCallback<T, M>*)c; (f->o->*f->m)(); }
+inline void sim_call_function(void* f) { (*(void (**)())f)(); }
+class Thread {
+public:
+	Thread(osPriority = osPriorityNormal, uint32_t = OS_STACK_SIZE, unsigned char* = 0, const char* = 0) : thread(0), function(0), member(0) {}
+	~Thread() { if (thread && sim_thread_finished(thread)) sim_thread_free(thread); }
+	template <typename T, typename M> osStatus start(MemberCallback<T, M> c) { if (thread) return osErrorResource; member = new MemberCallback<T, M>(c); thread = sim_thread_start(sim_call_member<T, M>, member); return osOK; }
+	osStatus start(void (*f)()) { if (thread) return osErrorResource; function = f; thread = sim_thread_start(sim_call_function, &function); return osOK; }
+	osStatus join() { while (thread && sim_wait(sim_thread_finished(thread), UINT64_MAX)) {} return osOK; }
+	sim_thread_t* thread;
+	void (*function)();
+	void* member;
+};
+class Semaphore {
+public:
+	Semaphore(int32_t count = 0) : tokens(count) {}
+	int32_t wait(uint32_t millisec = osWaitForever) { uint64_t end = sim_wait_end(millisec); while (sim_wait(tokens != 0, end)) {} return tokens ? tokens-- : 0; }
+	osStatus release() { ++tokens; return osOK; }
+	int32_t tokens;
+};
+// like Mail of mbed OS 5, alloc does not wait for free memory and returns 0 when the pool is empty
+template <typename T, uint32_t N> class Mail {
+public:
+	Mail() : head(0), count(0) { for (uint32_t i = 0; i != N; ++i) used[i] = false; }
+	T* alloc(uint32_t = 0) { for (uint32_t i = 0; i != N; ++i) if (!used[i]) { used[i] = true; return items + i; } return 0; }
+	T* calloc(uint32_t t = 0) { T* p = alloc(t); if (p) memset(p, 0, sizeof(T)); return p; }
+	osStatus put(T* p) { queue[(head + count++) % N] = p; return osOK; }
+	osEvent get(uint32_t millisec = osWaitForever) { uint64_t end = sim_wait_end(millisec); while (sim_wait(count != 0, end)) {} osEvent e; e.status = count ? osEventMail : osEventTimeout; e.value.p = 0; if (count) { e.value.p = queue[head]; head = (head + 1) % N; --count; } return e; }
+	osStatus free(T* p) { used[p - items] = false; return osOK; }
+	bool empty() { return !count; }
+	bool full() { return count == N; }
+	T items[N];
+	bool used[N];
+	T* queue[N];
+	uint32_t head;
+	uint32_t count;
+};
+#endif
@@ -0,0 +1,148 @@
+// Simulated time, tickers and threads of the host stub of mbed OS.
+#include "mbed.h"
+#include <stdlib.h>
+#include <ucontext.h>
+
+int sim_line = 0;
+int (*sim_noise)() = 0;
+bool sim_tx_muted = false;
+char sim_tx_log[1 << 20];
+size_t sim_tx_log_size;
+uint64_t sim_time_ns = 0;
+static Ticker* tickers = 0;
+static bool in_interrupt = false;
+
+struct sim_thread_t
+{
+	ucontext_t context;
+	void* stack;
+	void (*entry)(void*);
+	void* argument;
+	uint64_t wakeup_ns;
+	bool finished;
+	sim_thread_t* next;
+};
+
+// the main thread is the first thread of the list and it is never finished
+static sim_thread_t main_thread;
+static sim_thread_t* current_thread = &main_thread;
+static int running_thread_count = 0;
+
+#define SIM_THREAD_STACK_SIZE (1 << 20)
+
+Ticker::Ticker() : fn(0), oneshot(false), period_ns(0), next_ns(0) { next = tickers; tickers = this; }
+Ticker::~Ticker() { Ticker** p = &tickers; while (*p != this) p = &(*p)->next; *p = next; }
+
+void sim_advance_us(uint64_t us)
+{
+	// run the tickers in order of their next call time until the end time
+	uint64_t end = sim_time_ns + us * 1000;
+	for (;;)
+	{
+		Ticker* n = 0;
+		for (Ticker* t = tickers; t; t = t->next)
+			if (t->fn && (!n || t->next_ns < n->next_ns))
+				n = t;
+		if (!n || n->next_ns > end)
+			break;
+		sim_time_ns = n->next_ns;
+		n->next_ns += n->period_ns;
+		void (*f)() = n->fn;
+		if (n->oneshot)
+			n->fn = 0;
+		in_interrupt = true;
+		f();
+		in_interrupt = false;
+	}
+	sim_time_ns = end;
+}
+
+static void schedule()
+{
+	// the thread that wakes up first runs next, threads that wake up at the same time run in turns after the current thread
+	sim_thread_t* n = 0;
+	sim_thread_t* t = current_thread;
+	do
+	{
+		t = t->next ? t->next : &main_thread;
+		if (!t->finished && (!n || t->wakeup_ns < n->wakeup_ns))
+			n = t;
+	} while (t != current_thread);
+	if (n->wakeup_ns > sim_time_ns)
+		sim_advance_us((n->wakeup_ns - sim_time_ns) / 1000);
+	if (n != current_thread)
+	{
+		sim_thread_t* previous = current_thread;
+		current_thread = n;
+		swapcontext(&previous->context, &n->context);
+	}
+}
+
+void sim_sleep_us(uint64_t us)
+{
+	if (!running_thread_count)
+	{
+		sim_advance_us(us);
+		return;
+	}
+	current_thread->wakeup_ns = sim_time_ns + us * 1000;
+	schedule();
+}
+
+void sim_poll()
+{
+	if (running_thread_count && !in_interrupt)
+		sim_sleep_us(SIM_POLL_US);
+}
+
+bool sim_wait(bool done, uint64_t end_ns)
+{
+	if (done || sim_time_ns >= end_ns)
+		return false;
+	sim_sleep_us(SIM_POLL_US);
+	return true;
+}
+
+static void run_thread()
+{
+	current_thread->entry(current_thread->argument);
+	current_thread->finished = true;
+	--running_thread_count;
+	schedule();
+}
+
+sim_thread_t* sim_thread_start(void (*entry)(void*), void* argument)
+{
+	// the new thread runs when the current thread sleeps or waits
+	sim_thread_t* thread = (sim_thread_t*)calloc(1, sizeof(sim_thread_t));
+	thread->stack = malloc(SIM_THREAD_STACK_SIZE);
+	thread->entry = entry;
+	thread->argument = argument;
+	thread->wakeup_ns = sim_time_ns;
+	getcontext(&thread->context);
+	thread->context.uc_stack.ss_sp = thread->stack;
+	thread->context.uc_stack.ss_size = SIM_THREAD_STACK_SIZE;
+	thread->context.uc_link = 0;
+	makecontext(&thread->context, run_thread, 0);
+	sim_thread_t** p = &main_thread.next;
+	while (*p)
+		p = &(*p)->next;
+	*p = thread;
+	++running_thread_count;
+	return thread;
+}
+
+bool sim_thread_finished(sim_thread_t* thread)
+{
+	return thread->finished;
+}
+
+void sim_thread_free(sim_thread_t* thread)
+{
+	sim_thread_t** p = &main_thread.next;
+	while (*p != thread)
+		p = &(*p)->next;
+	*p = thread->next;
+	free(thread->stack);
+	free(thread);
+}
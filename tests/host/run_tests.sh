@@ -0,0 +1,16 @@
+#!/bin/sh
+# Builds and runs the host tests of mbed-os-ask with the mbed OS stub in this directory.
+# The transmitter and receiver buffers are enlarged, because nothing runs the interrupts while a send waits for buffer space.
+# Usage: run_tests.sh [test name...]
+set -e
+cd "$(dirname "$0")"
+CXX=${CXX:-g++}
+BUILD_DIRECTORY=${BUILD_DIRECTORY:-${TMPDIR:-/tmp}/mbed-os-ask-host-tests}
+FLAGS="-O2 -Wall -Wno-unused-function -I. -I../.. -DASK_TRANSMITTER_BUFFER_SIZE=1024 -DASK_RECEIVER_BUFFER_SIZE=1024"
+SOURCES="mbed_host.cpp ../../ask_transmitter.cpp ../../ask_spi_transmitter.cpp ../../ask_receiver.cpp ../../ask_CRC16.cpp ../../ask_fec.cpp ../../ask_scrambler.cpp"
+TESTS=${*:-"ask_render_test ask_fec_test ask_loopback_test ask_seed_test ask_tdma_join_test ask_tdma_async_test"}
+mkdir -p "$BUILD_DIRECTORY"
+for test in $TESTS; do
+	$CXX $FLAGS -o "$BUILD_DIRECTORY/$test" "$test.cpp" $SOURCES
+	"$BUILD_DIRECTORY/$test"
+done